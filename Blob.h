@@ -0,0 +1,52 @@
+//
+// Blob.h
+//
+// Element type of a given size for element size sweeps
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef BLOB_H
+#define BLOB_H
+
+#include <cstddef>
+#include <string>
+
+// Plain element of Bytes bytes. Tests use the hot field, i.e. data[Hot], as
+// key and counter while the rest of the blob is only copied around, so the
+// hot field can be moved away from the start to see the effect of touching a
+// different cache line of large elements.
+template <size_t Bytes, size_t Hot = 0>
+struct Blob {
+    static_assert(Bytes >= sizeof(int) && Bytes % sizeof(int) == 0, "blob size must be a multiple of int");
+    static_assert(Hot < Bytes / sizeof(int), "hot field must be inside the blob");
+
+    static const char* name()
+    {
+        static const std::string str = "Blob" + std::to_string(Bytes);
+        return str.c_str();
+    }
+    static const size_t scale = 1;
+
+    int data[Bytes / sizeof(int)];
+    bool operator<(const Blob& that) const
+    {
+        return this->data[Hot] < that.data[Hot];
+    }
+};
+
+// field of an element used as key and counter by the tests
+template <typename T>
+inline int& hot(T& t)
+{
+    return t.data[0];
+}
+
+template <size_t Bytes, size_t Hot>
+inline int& hot(Blob<Bytes, Hot>& t)
+{
+    return t.data[Hot];
+}
+
+#endif // BLOB_H
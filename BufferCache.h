@@ -0,0 +1,194 @@
+//
+// BufferCache.h
+//
+// Thread local cache of freed buffers in power of two size classes
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef BUFFER_CACHE_H
+#define BUFFER_CACHE_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Buffers released by containers are kept in a free list per size class, so
+// that the next container growing to a size of the same class takes the buffer
+// back instead of asking the allocator again. While the cache is enabled,
+// requests are rounded up to the next power of two bytes, which is their size
+// class, so that buffers of any size can be taken back by requests of the same
+// class, and buffers that are not a power of two bytes are never cached.
+//
+// Each buffer starts with a small header holding its requested and allocated
+// sizes, so that it can be released without the size. The cache is disabled
+// with both limits at zero, which is the default, and then every release frees
+// its buffer. A release that would exceed the total limit first trims the
+// largest cached buffers, while buffers that would exceed the limit of their
+// class are freed.
+class BufferCache {
+public:
+    BufferCache()
+        : cached(0)
+        , total_limit(0)
+        , class_limit(0)
+    {
+        for (size_t c = 0; c < classes; ++c) {
+            class_cached[c] = 0;
+        }
+    }
+
+    ~BufferCache() { trim(0); }
+
+    // cache of the calling thread
+    static BufferCache& local()
+    {
+        thread_local BufferCache cache;
+        return cache;
+    }
+
+    // byte limits of all cached buffers and of the buffers of each class
+    void set_limits(const size_t total, const size_t per_class)
+    {
+        total_limit = total;
+        class_limit = per_class;
+        trim(total);
+    }
+
+    size_t cached_bytes() const { return cached; }
+
+    void* allocate(const size_t bytes)
+    {
+        size_t c = size_class(bytes);
+        size_t capacity = bytes;
+        if (c < classes && total_limit > 0) {
+            capacity = size_t(1) << c;
+            if (!free_lists[c].empty()) {
+                char* raw = free_lists[c].back();
+                free_lists[c].pop_back();
+                cached -= capacity;
+                class_cached[c] -= capacity;
+                reinterpret_cast<Header*>(raw)->bytes = bytes;
+                return raw + header;
+            }
+        }
+        char* raw = static_cast<char*>(::operator new(header + capacity));
+        reinterpret_cast<Header*>(raw)->bytes = bytes;
+        reinterpret_cast<Header*>(raw)->capacity = capacity;
+        return raw + header;
+    }
+
+    void release(void* p)
+    {
+        char* raw = static_cast<char*>(p) - header;
+        size_t capacity = reinterpret_cast<Header*>(raw)->capacity;
+        size_t c = size_class(capacity);
+        if (c >= classes || capacity != (size_t(1) << c) || capacity > total_limit ||
+            class_cached[c] + capacity > class_limit) {
+            ::operator delete(raw);
+            return;
+        }
+        if (cached + capacity > total_limit) {
+            trim(total_limit - capacity);
+        }
+        free_lists[c].push_back(raw);
+        cached += capacity;
+        class_cached[c] += capacity;
+    }
+
+    // frees cached buffers starting from the largest class until at most keep
+    // bytes are cached
+    void trim(const size_t keep)
+    {
+        for (size_t c = classes; c > 0 && cached > keep; --c) {
+            std::vector<char*>& list = free_lists[c - 1];
+            while (!list.empty() && cached > keep) {
+                ::operator delete(list.back());
+                list.pop_back();
+                cached -= size_t(1) << (c - 1);
+                class_cached[c - 1] -= size_t(1) << (c - 1);
+            }
+        }
+    }
+
+    // requested bytes of a buffer returned by allocate
+    static size_t size(void* p) { return reinterpret_cast<Header*>(static_cast<char*>(p) - header)->bytes; }
+
+private:
+    struct Header {
+        size_t bytes;
+        size_t capacity;
+    };
+
+    static const size_t classes = 8 * sizeof(size_t);
+    static const size_t header = (sizeof(Header) + alignof(std::max_align_t) - 1) /
+                                 alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    // log2 of the smallest power of two of at least the given bytes, or
+    // classes if there is none
+    static size_t size_class(const size_t bytes)
+    {
+        size_t c = 0;
+        while (c < classes && (size_t(1) << c) < bytes) {
+            c++;
+        }
+        return c;
+    }
+
+    std::vector<char*> free_lists[classes];
+    size_t class_cached[classes];
+    size_t cached;
+    size_t total_limit;
+    size_t class_limit;
+};
+
+// Sets the limits of the cache of the calling thread for a scope, and frees
+// all cached buffers at the end of it.
+class BufferCacheScope {
+public:
+    BufferCacheScope(const size_t total, const size_t per_class)
+    {
+        BufferCache::local().set_limits(total, per_class);
+    }
+
+    ~BufferCacheScope() { BufferCache::local().set_limits(0, 0); }
+};
+
+// Array of n default initialized elements, i.e. new T[n], in a buffer from the
+// cache of the calling thread. The cache is only used in builds that define
+// BENCH_BUFFER_CACHE (e.g. "make cached"), so that other builds allocate
+// without the header and the lookup of the cache.
+template <typename T>
+inline T* buffer_new(const size_t n)
+{
+#ifdef BENCH_BUFFER_CACHE
+    T* data = static_cast<T*>(BufferCache::local().allocate(n * sizeof(T)));
+    for (size_t i = 0; i < n; ++i) {
+        new (data + i) T;
+    }
+    return data;
+#else
+    return new T[n];
+#endif
+}
+
+// destroys the elements of an array from buffer_new and releases its buffer
+template <typename T>
+inline void buffer_delete(T* data)
+{
+#ifdef BENCH_BUFFER_CACHE
+    if (data == nullptr) {
+        return;
+    }
+    size_t n = BufferCache::size(data) / sizeof(T);
+    for (size_t i = 0; i < n; ++i) {
+        data[i].~T();
+    }
+    BufferCache::local().release(data);
+#else
+    delete[] data;
+#endif
+}
+
+#endif // BUFFER_CACHE_H
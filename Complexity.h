@@ -0,0 +1,102 @@
+//
+// Complexity.h
+//
+// Empirical complexity fitting of timings against sizes
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef COMPLEXITY_H
+#define COMPLEXITY_H
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+enum Complexity {
+    O_1,
+    O_LOG_N,
+    O_N,
+    O_N_LOG_N,
+    O_N2,
+    COMPLEXITY_COUNT,
+};
+
+inline const char* complexity_name(const Complexity c)
+{
+    static const char* names[] = { "O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)" };
+    return names[c];
+}
+
+inline double complexity_value(const Complexity c, const double n)
+{
+    switch (c) {
+    case O_1:
+        return 1;
+    case O_LOG_N:
+        return std::log2(n);
+    case O_N:
+        return n;
+    case O_N_LOG_N:
+        return n * std::log2(n);
+    default:
+        return n * n;
+    }
+}
+
+struct Fit {
+    Complexity best;
+    double coefficient[COMPLEXITY_COUNT];
+    double error[COMPLEXITY_COUNT]; // rms of residuals relative to the mean
+
+    // how much worse the given model explains the data than the best one
+    double ratio(const Complexity c) const
+    {
+        return error[best] > 0 ? error[c] / error[best] : (error[c] > 0 ? HUGE_VAL : 1);
+    }
+};
+
+// Fits t = c * g(n) with least squares for each model g and picks the one with
+// the smallest residual. Sizes should span at least a few multiples for the
+// models to be distinguishable.
+inline Fit fit_complexity(const std::vector<double>& ns, const std::vector<double>& ts)
+{
+    Fit fit;
+    fit.best = O_1;
+
+    double mean = 0;
+    for (const double t : ts) {
+        mean += t;
+    }
+    mean /= ts.size();
+
+    for (int i = 0; i < COMPLEXITY_COUNT; ++i) {
+        Complexity c = static_cast<Complexity>(i);
+        double gt = 0;
+        double gg = 0;
+        for (size_t j = 0; j < ns.size(); ++j) {
+            double g = complexity_value(c, ns[j]);
+            gt += g * ts[j];
+            gg += g * g;
+        }
+        double coef = gg > 0 ? gt / gg : 0;
+
+        double sq = 0;
+        for (size_t j = 0; j < ns.size(); ++j) {
+            double r = ts[j] - coef * complexity_value(c, ns[j]);
+            sq += r * r;
+        }
+        fit.coefficient[c] = coef;
+        fit.error[c] = mean > 0 ? std::sqrt(sq / ns.size()) / mean : 0;
+
+        if (fit.error[c] < fit.error[fit.best]) {
+            fit.best = c;
+        }
+    }
+
+    return fit;
+}
+
+#endif // COMPLEXITY_H
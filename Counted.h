@@ -0,0 +1,162 @@
+//
+// Counted.h
+//
+// Instrumented element types counting constructions, copies, moves and
+// destructions
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef COUNTED_H
+#define COUNTED_H
+
+#include <cstddef>
+#include <type_traits>
+
+struct ElementCounts {
+    size_t default_constructs;
+    size_t copy_constructs;
+    size_t copy_assigns;
+    size_t move_constructs;
+    size_t move_assigns;
+    size_t destructs;
+
+    size_t copies() const { return copy_constructs + copy_assigns; }
+    size_t moves() const { return move_constructs + move_assigns; }
+};
+
+// counters of the calling thread, shared by all instrumented types
+inline ElementCounts& element_counts()
+{
+    static thread_local ElementCounts counts = ElementCounts();
+    return counts;
+}
+
+inline void reset_element_counts()
+{
+    element_counts() = ElementCounts();
+}
+
+template <typename T>
+struct is_counted : std::false_type {
+};
+
+// same layout as Small with every special member function counted
+struct Counted {
+    static const char* name() { return "Counted"; }
+    static const size_t scale = 100;
+
+    int data[1];
+
+    Counted()
+        : data()
+    {
+        element_counts().default_constructs++;
+    }
+
+    Counted(const Counted& that)
+    {
+        data[0] = that.data[0];
+        element_counts().copy_constructs++;
+    }
+
+    Counted(Counted&& that) noexcept
+    {
+        data[0] = that.data[0];
+        element_counts().move_constructs++;
+    }
+
+    Counted& operator=(const Counted& that)
+    {
+        data[0] = that.data[0];
+        element_counts().copy_assigns++;
+        return *this;
+    }
+
+    Counted& operator=(Counted&& that) noexcept
+    {
+        data[0] = that.data[0];
+        element_counts().move_assigns++;
+        return *this;
+    }
+
+    ~Counted() { element_counts().destructs++; }
+
+    bool operator<(const Counted& that) const
+    {
+        return this->data[0] < that.data[0];
+    }
+};
+
+// Counted with its value on the heap so that copies allocate while moves only
+// steal the pointer. Moved from elements have no value and read as zero when
+// copied.
+struct CountedHeap {
+    static const char* name() { return "CountedHeap"; }
+    static const size_t scale = 10;
+
+    int* data;
+
+    CountedHeap()
+        : data(new int[1]())
+    {
+        element_counts().default_constructs++;
+    }
+
+    CountedHeap(const CountedHeap& that)
+        : data(new int[1])
+    {
+        data[0] = that.data ? that.data[0] : 0;
+        element_counts().copy_constructs++;
+    }
+
+    CountedHeap(CountedHeap&& that) noexcept
+        : data(that.data)
+    {
+        that.data = nullptr;
+        element_counts().move_constructs++;
+    }
+
+    CountedHeap& operator=(const CountedHeap& that)
+    {
+        if (this != &that) {
+            if (!data) {
+                data = new int[1];
+            }
+            data[0] = that.data ? that.data[0] : 0;
+        }
+        element_counts().copy_assigns++;
+        return *this;
+    }
+
+    CountedHeap& operator=(CountedHeap&& that) noexcept
+    {
+        int* tmp = data;
+        data = that.data;
+        that.data = tmp;
+        element_counts().move_assigns++;
+        return *this;
+    }
+
+    ~CountedHeap()
+    {
+        delete[] data;
+        element_counts().destructs++;
+    }
+
+    bool operator<(const CountedHeap& that) const
+    {
+        return this->data[0] < that.data[0];
+    }
+};
+
+template <>
+struct is_counted<Counted> : std::true_type {
+};
+
+template <>
+struct is_counted<CountedHeap> : std::true_type {
+};
+
+#endif // COUNTED_H
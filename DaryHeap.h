@@ -0,0 +1,116 @@
+//
+// DaryHeap.h
+//
+// Priority queue adaptor with a d-ary heap over a random access container
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef DARY_HEAP_H
+#define DARY_HEAP_H
+
+#include <cstddef>
+#include <utility>
+
+// Max heap of T on top of any container with push_back, pop_back and
+// operator[], comparing elements with operator<. Each node has Arity children
+// which are stored next to each other. The root is placed at index Arity - 1
+// after padding elements, so that every group of children starts at a multiple
+// of Arity, i.e. on a cache line boundary when Arity elements fill a line and
+// the storage of the container is line aligned. The adaptor does not allocate
+// the storage, and the containers get theirs from operator new, which only
+// aligns to alignof(std::max_align_t), so a group may still span two lines.
+template <typename Container, typename T, size_t Arity = 2>
+class DaryHeap {
+public:
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    DaryHeap()
+        : count(0)
+    {
+        for (size_t i = 0; i < root; ++i) {
+            data.push_back(T());
+        }
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& top() { return data[root]; }
+
+    void push(const T& val)
+    {
+        data.push_back(val);
+        count++;
+        sift_up(root + count - 1);
+    }
+
+    void pop()
+    {
+        count--;
+        if (count > 0) {
+            T val = data[root + count];
+            data.pop_back();
+            sift_down(val);
+        } else {
+            data.pop_back();
+        }
+    }
+
+    Container& container() { return data; }
+
+private:
+    static const size_t root = Arity - 1;
+
+    // positions are indices in the container, i.e. including the padding
+    static size_t parent(const size_t pos) { return (pos - root - 1) / Arity + root; }
+    static size_t first_child(const size_t pos) { return (pos - root) * Arity + Arity; }
+
+    // moves parents down into the hole until the value fits
+    void sift_up(size_t pos)
+    {
+        T val = data[pos];
+        while (pos > root) {
+            size_t up = parent(pos);
+            if (!(data[up] < val)) {
+                break;
+            }
+            data[pos] = data[up];
+            pos = up;
+        }
+        data[pos] = val;
+    }
+
+    // moves the largest children up into the hole starting at the root until
+    // the value fits
+    void sift_down(const T& val)
+    {
+        const size_t end = root + count;
+        size_t pos = root;
+        for (;;) {
+            size_t child = first_child(pos);
+            if (child >= end) {
+                break;
+            }
+            size_t last = child + Arity < end ? child + Arity : end;
+            size_t best = child;
+            for (size_t i = child + 1; i < last; ++i) {
+                if (data[best] < data[i]) {
+                    best = i;
+                }
+            }
+            if (!(val < data[best])) {
+                break;
+            }
+            data[pos] = data[best];
+            pos = best;
+        }
+        data[pos] = val;
+    }
+
+    Container data;
+    size_t count;
+};
+
+#endif // DARY_HEAP_H
@@ -13,9 +13,18 @@
 #include <algorithm>
 #include <iostream>
 
+#include "BufferCache.h"
+#include "Operations.h"
+
 template <typename T>
 class DequeConservative {
 public:
+    static const char* name() { return "DequeConservative"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT |
+                                       OP_POP_FRONT | OP_RANDOM_ACCESS |
+                                       OP_RESERVE_BACK | OP_RESERVE_FRONT |
+                                       OP_LOAD_FACTOR | OP_SEAM | OP_INSERT;
+
     DequeConservative()
         : back_capacity(1)
         , front_capacity(1)
@@ -24,14 +33,14 @@ public:
         , back_offset(0)
         , front_offset(0)
     {
-        back_data = new T[back_capacity];
-        front_data = new T[front_capacity];
+        back_data = buffer_new<T>(back_capacity);
+        front_data = buffer_new<T>(front_capacity);
     }
 
     ~DequeConservative()
     {
-        delete[] back_data;
-        delete[] front_data;
+        buffer_delete(back_data);
+        buffer_delete(front_data);
     }
 
     T& operator[](size_t ind)
@@ -43,6 +52,27 @@ public:
         }
     }
 
+    T& front()
+    {
+        if (front_size > 0) {
+            return front_data[(front_size + front_offset) - 1];
+        } else {
+            return back_data[back_offset];
+        }
+    }
+
+    T& back()
+    {
+        if (back_size > 0) {
+            return back_data[(back_size + back_offset) - 1];
+        } else {
+            return front_data[front_offset];
+        }
+    }
+
+    // elements before the seam are in the front array and the rest in the back
+    size_t seam() { return front_size; }
+
     float load_factor()
     {
         return static_cast<float>(front_size + back_size) / (front_capacity + back_capacity);
@@ -51,28 +81,28 @@ public:
     void reserve_back(size_t n)
     {
         if (n + back_offset > back_capacity) {
-            back_offset = 0;
-            back_capacity = n + back_offset;
-            T* new_data = new T[back_capacity];
+            back_capacity = n;
+            T* new_data = buffer_new<T>(back_capacity);
             std::copy(back_data + back_offset,
                       back_data + back_offset + back_size,
-                      new_data + back_offset);
-            delete[] back_data;
+                      new_data);
+            buffer_delete(back_data);
             back_data = new_data;
+            back_offset = 0;
         }
     }
 
     void reserve_front(size_t n)
     {
         if (n + front_offset > front_capacity) {
-            front_offset = 0;
-            front_capacity = n + front_offset;
-            T* new_data = new T[front_capacity];
+            front_capacity = n;
+            T* new_data = buffer_new<T>(front_capacity);
             std::copy(front_data + front_offset,
                       front_data + front_offset + front_size,
-                      new_data + front_offset);
-            delete[] front_data;
+                      new_data);
+            buffer_delete(front_data);
             front_data = new_data;
+            front_offset = 0;
         }
     }
 
@@ -82,18 +112,18 @@ public:
             if (back_size + back_offset >= back_capacity) {
                 if ((static_cast<float>(back_size) / back_capacity) >= 0.5) {
                     back_capacity *= 2;
-                    T* new_data = new T[back_capacity];
-                    back_offset = 0;
+                    T* new_data = buffer_new<T>(back_capacity);
                     std::copy(back_data + back_offset,
                               back_data + back_offset + back_size,
-                              new_data + back_offset);
-                    delete[] back_data;
+                              new_data);
+                    buffer_delete(back_data);
                     back_data = new_data;
-                } else {
                     back_offset = 0;
+                } else {
                     std::move(back_data + back_offset,
                               back_data + back_offset + back_size,
-                              back_data + back_offset);
+                              back_data);
+                    back_offset = 0;
                 }
             }
             back_data[back_size + back_offset] = val;
@@ -125,18 +155,18 @@ public:
             if (front_size + front_offset >= front_capacity) {
                 if ((static_cast<float>(front_size) / front_capacity) >= 0.5) {
                     front_capacity *= 2;
-                    T* new_data = new T[front_capacity];
-                    front_offset = 0;
+                    T* new_data = buffer_new<T>(front_capacity);
                     std::copy(front_data + front_offset,
                               front_data + front_offset + front_size,
-                              new_data + front_offset);
-                    delete[] front_data;
+                              new_data);
+                    buffer_delete(front_data);
                     front_data = new_data;
-                } else {
                     front_offset = 0;
+                } else {
                     std::move(front_data + front_offset,
                               front_data + front_offset + front_size,
-                              front_data + front_offset);
+                              front_data);
+                    front_offset = 0;
                 }
             }
             front_data[front_size + front_offset] = val;
@@ -162,6 +192,85 @@ public:
         }
     }
 
+    // Inserts before index pos, moving whichever side of the position is
+    // shorter within the array holding it. Elements of the front array move
+    // outwards or into the space left at the seam, and elements of the back
+    // array move outwards or into the space left at its start.
+    void insert(size_t pos, const T& val)
+    {
+        if (pos < front_size) {
+            if (front_offset > 0 && front_size - pos < pos) {
+                std::move(front_data + front_offset,
+                          front_data + front_offset + front_size - pos,
+                          front_data + front_offset - 1);
+                front_offset--;
+                front_size++;
+            } else {
+                push_front(val);
+                std::move_backward(front_data + front_offset + front_size - 1 - pos,
+                                   front_data + front_offset + front_size - 1,
+                                   front_data + front_offset + front_size);
+            }
+            front_data[front_offset + front_size - 1 - pos] = val;
+        } else {
+            size_t ind = pos - front_size;
+            if (ind == back_size) {
+                push_back(val);
+            } else if (back_offset > 0 && ind < back_size - ind) {
+                std::move(back_data + back_offset,
+                          back_data + back_offset + ind,
+                          back_data + back_offset - 1);
+                back_offset--;
+                back_size++;
+                back_data[back_offset + ind] = val;
+            } else {
+                push_back(val);
+                std::move_backward(back_data + back_offset + ind,
+                                   back_data + back_offset + back_size - 1,
+                                   back_data + back_offset + back_size);
+                back_data[back_offset + ind] = val;
+            }
+        }
+    }
+
+    void erase(size_t pos) { erase(pos, pos + 1); }
+
+    // erases indices from first to last - 1, separately in each array moving
+    // the shorter side
+    void erase(size_t first, size_t last)
+    {
+        if (last > front_size) {
+            size_t a = std::max(first, front_size) - front_size;
+            size_t b = last - front_size;
+            if (a < back_size - b) {
+                std::move_backward(back_data + back_offset,
+                                   back_data + back_offset + a,
+                                   back_data + back_offset + b);
+                back_offset += b - a;
+            } else {
+                std::move(back_data + back_offset + b,
+                          back_data + back_offset + back_size,
+                          back_data + back_offset + a);
+            }
+            back_size -= b - a;
+        }
+        if (first < front_size) {
+            size_t a = first;
+            size_t b = std::min(last, front_size);
+            if (a < front_size - b) {
+                std::move(front_data + front_offset + front_size - a,
+                          front_data + front_offset + front_size,
+                          front_data + front_offset + front_size - b);
+            } else {
+                std::move_backward(front_data + front_offset,
+                                   front_data + front_offset + front_size - b,
+                                   front_data + front_offset + front_size - a);
+                front_offset += b - a;
+            }
+            front_size -= b - a;
+        }
+    }
+
     void draw()
     {
         for (size_t i = front_capacity; i > 0; --i) {
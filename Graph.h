@@ -0,0 +1,154 @@
+//
+// Graph.h
+//
+// Synthetic graphs in compressed sparse row form for traversal workloads
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+enum GraphKind {
+    GRAPH_GRID,      // square grid with edges to the four neighbors
+    GRAPH_REGULAR,   // random regular graph of degree GRAPH_DEGREE
+    GRAPH_POWER_LAW, // preferential attachment with GRAPH_DEGREE / 2 edges per vertex
+};
+
+static const size_t GRAPH_DEGREE = 8;
+
+// Edges of vertex v are edges[offsets[v]] to edges[offsets[v + 1] - 1], each
+// undirected edge is stored in both directions.
+struct Graph {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> edges;
+
+    size_t vertices() const { return offsets.size() - 1; }
+};
+
+inline const char* graph_name(const GraphKind kind)
+{
+    switch (kind) {
+    case GRAPH_REGULAR:
+        return "Regular";
+    case GRAPH_POWER_LAW:
+        return "PowerLaw";
+    default:
+        return "Grid";
+    }
+}
+
+// side of the grid with about n vertices
+inline size_t grid_side(const size_t n)
+{
+    size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(n)) + 0.5);
+    return side > 0 ? side : 1;
+}
+
+// number of stored (i.e. directed) edges of the graph with about n vertices
+inline size_t graph_edges(const GraphKind kind, const size_t n)
+{
+    const size_t m = GRAPH_DEGREE / 2;
+    switch (kind) {
+    case GRAPH_GRID: {
+        size_t side = grid_side(n);
+        return 4 * side * (side - 1);
+    }
+    case GRAPH_REGULAR:
+        return n * GRAPH_DEGREE;
+    default:
+        return n > m + 1 ? (m + 1) * m + 2 * m * (n - m - 1) : n * (n - 1);
+    }
+}
+
+// builds the csr form from undirected edges
+inline void build_graph(const size_t vertices,
+                        const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                        Graph& graph)
+{
+    graph.offsets.assign(vertices + 1, 0);
+    for (const auto& e : pairs) {
+        graph.offsets[e.first + 1]++;
+        graph.offsets[e.second + 1]++;
+    }
+    for (size_t v = 0; v < vertices; ++v) {
+        graph.offsets[v + 1] += graph.offsets[v];
+    }
+    graph.edges.resize(2 * pairs.size());
+    std::vector<uint32_t> pos(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const auto& e : pairs) {
+        graph.edges[pos[e.first]++] = e.second;
+        graph.edges[pos[e.second]++] = e.first;
+    }
+}
+
+// Generates a graph with about n vertices from a fixed seed. Random regular
+// graphs pair up the edge stubs of all vertices at random, so they may have a
+// few loops and multiple edges. Power law graphs start from a clique and
+// attach each new vertex to existing ones picked in proportion to their
+// degree.
+inline void generate_graph(const GraphKind kind, const size_t n, Graph& graph)
+{
+    std::mt19937 gen(1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    size_t vertices = n;
+
+    if (kind == GRAPH_GRID) {
+        const size_t side = grid_side(n);
+        vertices = side * side;
+        for (size_t r = 0; r < side; ++r) {
+            for (size_t c = 0; c < side; ++c) {
+                uint32_t v = static_cast<uint32_t>(r * side + c);
+                if (c + 1 < side) {
+                    pairs.push_back(std::make_pair(v, v + 1));
+                }
+                if (r + 1 < side) {
+                    pairs.push_back(std::make_pair(v, static_cast<uint32_t>(v + side)));
+                }
+            }
+        }
+    } else if (kind == GRAPH_REGULAR) {
+        std::vector<uint32_t> stubs;
+        for (size_t v = 0; v < n; ++v) {
+            for (size_t d = 0; d < GRAPH_DEGREE; ++d) {
+                stubs.push_back(static_cast<uint32_t>(v));
+            }
+        }
+        std::shuffle(stubs.begin(), stubs.end(), gen);
+        for (size_t i = 0; i + 1 < stubs.size(); i += 2) {
+            pairs.push_back(std::make_pair(stubs[i], stubs[i + 1]));
+        }
+    } else {
+        const size_t m = GRAPH_DEGREE / 2;
+        const size_t clique = std::min(n, m + 1);
+        std::vector<uint32_t> ends;
+        for (size_t u = 0; u < clique; ++u) {
+            for (size_t v = u + 1; v < clique; ++v) {
+                pairs.push_back(std::make_pair(static_cast<uint32_t>(u), static_cast<uint32_t>(v)));
+                ends.push_back(static_cast<uint32_t>(u));
+                ends.push_back(static_cast<uint32_t>(v));
+            }
+        }
+        for (size_t v = clique; v < n; ++v) {
+            std::uniform_int_distribution<size_t> pick(0, ends.size() - 1);
+            for (size_t i = 0; i < m; ++i) {
+                uint32_t u = ends[pick(gen)];
+                pairs.push_back(std::make_pair(u, static_cast<uint32_t>(v)));
+                ends.push_back(u);
+                ends.push_back(static_cast<uint32_t>(v));
+            }
+        }
+    }
+
+    build_graph(vertices, pairs, graph);
+}
+
+#endif // GRAPH_H
@@ -0,0 +1,57 @@
+//
+// HeapStats.h
+//
+// Resident memory and allocator statistics of the running process
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef HEAP_STATS_H
+#define HEAP_STATS_H
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <fstream>
+
+// resident set size in bytes from /proc/self/statm, 0 if it can not be read
+inline size_t resident_bytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    size_t total = 0;
+    size_t resident = 0;
+    if (!(statm >> total >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Fraction of the heap (i.e. memory obtained with brk and arena heaps, but not
+// chunks mapped on their own) held in free chunks by the allocator, which is
+// the memory lost to fragmentation when containers are live. Returns 0 when
+// allocator statistics are not available.
+inline double heap_fragmentation()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.arena > 0 ? static_cast<double>(info.fordblks) / info.arena : 0;
+#else
+    return 0;
+#endif
+}
+
+// bytes handed out by the allocator, including chunks mapped on their own,
+// returns 0 when allocator statistics are not available
+inline size_t heap_in_use()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+#endif // HEAP_STATS_H
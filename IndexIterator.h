@@ -0,0 +1,121 @@
+//
+// IndexIterator.h
+//
+// Random access iterator over any container with operator[]
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef INDEX_ITERATOR_H
+#define INDEX_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Holds a container and an index, and dereferences through operator[] of the
+// container, so that standard algorithms can run over containers without
+// iterators of their own. The cost of each access is then the cost of
+// operator[], which is what the algorithm tests compare.
+template <typename C>
+class IndexIterator {
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef typename std::remove_reference<decltype(std::declval<C&>()[0])>::type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+
+    IndexIterator()
+        : c(nullptr)
+        , ind(0)
+    {
+    }
+
+    IndexIterator(C& c, const size_t ind)
+        : c(&c)
+        , ind(ind)
+    {
+    }
+
+    reference operator*() const { return (*c)[ind]; }
+    pointer operator->() const { return &(*c)[ind]; }
+    reference operator[](const difference_type d) const { return (*c)[ind + d]; }
+
+    IndexIterator& operator++()
+    {
+        ++ind;
+        return *this;
+    }
+
+    IndexIterator& operator--()
+    {
+        --ind;
+        return *this;
+    }
+
+    IndexIterator operator++(int)
+    {
+        IndexIterator tmp = *this;
+        ++ind;
+        return tmp;
+    }
+
+    IndexIterator operator--(int)
+    {
+        IndexIterator tmp = *this;
+        --ind;
+        return tmp;
+    }
+
+    IndexIterator& operator+=(const difference_type d)
+    {
+        ind += d;
+        return *this;
+    }
+
+    IndexIterator& operator-=(const difference_type d)
+    {
+        ind -= d;
+        return *this;
+    }
+
+    IndexIterator operator+(const difference_type d) const { return IndexIterator(*c, ind + d); }
+    IndexIterator operator-(const difference_type d) const { return IndexIterator(*c, ind - d); }
+
+    difference_type operator-(const IndexIterator& that) const
+    {
+        return static_cast<difference_type>(ind) - static_cast<difference_type>(that.ind);
+    }
+
+    bool operator==(const IndexIterator& that) const { return ind == that.ind; }
+    bool operator!=(const IndexIterator& that) const { return ind != that.ind; }
+    bool operator<(const IndexIterator& that) const { return ind < that.ind; }
+    bool operator>(const IndexIterator& that) const { return ind > that.ind; }
+    bool operator<=(const IndexIterator& that) const { return ind <= that.ind; }
+    bool operator>=(const IndexIterator& that) const { return ind >= that.ind; }
+
+    friend IndexIterator operator+(const difference_type d, const IndexIterator& it) { return it + d; }
+
+private:
+    C* c;
+    size_t ind;
+};
+
+// iterators over the first n elements of a container, which do not need to
+// know its size
+template <typename C>
+inline IndexIterator<C> index_begin(C& c)
+{
+    return IndexIterator<C>(c, 0);
+}
+
+template <typename C>
+inline IndexIterator<C> index_end(C& c, const size_t n)
+{
+    return IndexIterator<C>(c, n);
+}
+
+#endif // INDEX_ITERATOR_H
@@ -0,0 +1,337 @@
+//
+// MappedQueue.h
+//
+// Queue implementation with reclaiming memory management schema in a mapped file
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef MAPPED_QUEUE_H
+#define MAPPED_QUEUE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "Operations.h"
+
+static const char MAPPED_QUEUE_MAGIC[8] = { 'S', 'T', 'L', 'B', 'Q', 'U', 'E', 'U' };
+
+// Elements are stored in a file mapped into memory after a header page, which
+// holds the capacity and two slots of head and tail indices, one of which is
+// active. Pushes and pops store an element and then the index moved by the
+// operation, so the file holds a valid queue after the last store of a process
+// that crashed. When the tail reaches the end of the file, elements are copied
+// to the start if they fit before the head, and the other slot is activated
+// with a single store, otherwise the file is doubled and mapped again.
+//
+// Default constructed queues use a temporary file, which is removed along with
+// the queue, and open() uses a given file instead, which keeps its elements
+// when the queue is destroyed and recovers them when it is opened again.
+// Stores reach the page cache, which survives the process, and sync() or a
+// sync interval also writes them to the disk to survive the system.
+template <typename T>
+class MappedQueue {
+public:
+    static const char* name() { return "MappedQueue"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_POP_FRONT |
+                                       OP_RANDOM_ACCESS | OP_LOAD_FACTOR |
+                                       OP_PERSISTENT;
+
+    MappedQueue()
+        : header(nullptr)
+        , data(nullptr)
+        , ind(&none)
+        , map_size(0)
+        , temporary(false)
+        , sync_interval(0)
+        , unsynced(0)
+    {
+        none.head = 0;
+        none.tail = 0;
+    }
+
+    ~MappedQueue() { close_file(); }
+
+    // Opens the queue stored in the file at path, which is created if it does
+    // not exist. Returns false and prints a message if the file can not be
+    // used, in which case the queue is left empty.
+    bool open(const std::string& file)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "recovered elements are used as stored");
+        close_file();
+        return open_file(file, false);
+    }
+
+    // writes the elements and indices to the disk every given number of
+    // operations, or never with 0
+    void set_sync_interval(const size_t ops)
+    {
+        sync_interval = ops;
+        unsynced = 0;
+    }
+
+    void sync()
+    {
+        if (header != nullptr) {
+            msync(header, map_size, MS_SYNC);
+        }
+        unsynced = 0;
+    }
+
+    T& operator[](size_t i) { return data[ind->head + i]; }
+    T& front() { return data[ind->head]; }
+    T& back() { return data[ind->tail - 1]; }
+
+    size_t size() const { return ind->tail - ind->head; }
+
+    float load_factor()
+    {
+        return header != nullptr ? static_cast<float>(size()) / header->capacity : 0;
+    }
+
+    void push_back(const T& val)
+    {
+        if (ind->tail == capacity()) {
+            make_room();
+        }
+        new (data + ind->tail) T(val);
+        std::atomic_signal_fence(std::memory_order_release);
+        ind->tail++;
+        stored();
+    }
+
+    void pop_back()
+    {
+        ind->tail--;
+        std::atomic_signal_fence(std::memory_order_release);
+        data[ind->tail].~T();
+        stored();
+    }
+
+    void pop_front()
+    {
+        ind->head++;
+        std::atomic_signal_fence(std::memory_order_release);
+        data[ind->head - 1].~T();
+        stored();
+    }
+
+    void draw()
+    {
+        std::cout << "|";
+        for (size_t i = 0; i < capacity(); ++i) {
+            std::cout << (i >= ind->head && i < ind->tail ? "x|" : " |");
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    MappedQueue(const MappedQueue&);
+    MappedQueue& operator=(const MappedQueue&);
+
+    struct Indices {
+        uint64_t head;
+        uint64_t tail;
+    };
+
+    struct Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t capacity;
+        uint64_t active;
+        Indices slots[2];
+    };
+
+    static size_t page_size() { return static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
+
+    size_t capacity() const { return header != nullptr ? header->capacity : 0; }
+
+    size_t file_size(const size_t capacity) const { return page_size() + capacity * sizeof(T); }
+
+    void stored()
+    {
+        if (sync_interval > 0 && ++unsynced == sync_interval) {
+            sync();
+        }
+    }
+
+    // maps the header page and the given capacity of the file
+    bool map_file(const int fd, const size_t capacity)
+    {
+        size_t size = file_size(capacity);
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        header = static_cast<Header*>(map);
+        data = reinterpret_cast<T*>(static_cast<char*>(map) + page_size());
+        ind = &header->slots[header->active];
+        map_size = size;
+        return true;
+    }
+
+    bool open_file(const std::string& file, const bool remove)
+    {
+        int fd = ::open(file.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            std::cerr << "cannot open queue file '" << file << "'" << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            std::cerr << "cannot open queue file '" << file << "'" << std::endl;
+            ::close(fd);
+            return false;
+        }
+
+        bool ok;
+        if (st.st_size == 0) {
+            size_t capacity = std::max<size_t>(page_size() / sizeof(T), 1);
+            ok = ftruncate(fd, static_cast<off_t>(file_size(capacity))) == 0 && map_file(fd, capacity);
+            if (ok) {
+                // the file is zero filled, so only the magic marks it as a queue
+                header->element_size = sizeof(T);
+                header->capacity = capacity;
+                std::atomic_signal_fence(std::memory_order_release);
+                std::memcpy(header->magic, MAPPED_QUEUE_MAGIC, sizeof(MAPPED_QUEUE_MAGIC));
+            }
+        } else {
+            Header h;
+            ok = pread(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+                 std::memcmp(h.magic, MAPPED_QUEUE_MAGIC, sizeof(MAPPED_QUEUE_MAGIC)) == 0 &&
+                 h.element_size == sizeof(T) && h.active < 2 &&
+                 h.slots[h.active].head <= h.slots[h.active].tail &&
+                 h.slots[h.active].tail <= h.capacity &&
+                 file_size(h.capacity) <= static_cast<size_t>(st.st_size);
+            if (!ok) {
+                std::cerr << "queue file '" << file << "' has an unknown format" << std::endl;
+                ::close(fd);
+                return false;
+            }
+            ok = map_file(fd, h.capacity);
+        }
+        ::close(fd);
+        if (!ok) {
+            std::cerr << "cannot map queue file '" << file << "'" << std::endl;
+            header = nullptr;
+            data = nullptr;
+            ind = &none;
+            return false;
+        }
+        path = file;
+        temporary = remove;
+        return true;
+    }
+
+    void close_file()
+    {
+        if (header == nullptr) {
+            return;
+        }
+        if (temporary) {
+            for (size_t i = ind->head; i < ind->tail; ++i) {
+                data[i].~T();
+            }
+        } else if (sync_interval > 0) {
+            sync();
+        }
+        munmap(header, map_size);
+        if (temporary) {
+            unlink(path.c_str());
+        }
+        header = nullptr;
+        data = nullptr;
+        ind = &none;
+        map_size = 0;
+    }
+
+    // Creates a temporary file in TMPDIR, or /tmp if it is not set, and keeps
+    // its name to remove it later, since the file is opened again to grow.
+    void open_temporary()
+    {
+        const char* dir = std::getenv("TMPDIR");
+        std::string file = std::string(dir != nullptr ? dir : "/tmp") + "/mapped-queue-XXXXXX";
+        int fd = mkstemp(&file[0]);
+        if (fd < 0) {
+            throw std::bad_alloc();
+        }
+        ::close(fd);
+        if (!open_file(file, true)) {
+            unlink(file.c_str());
+            throw std::bad_alloc();
+        }
+    }
+
+    void make_room()
+    {
+        if (header == nullptr) {
+            open_temporary();
+            return;
+        }
+        const size_t head = ind->head;
+        const size_t tail = ind->tail;
+        const size_t n = tail - head;
+        if (head >= n) {
+            std::uninitialized_copy(data + head, data + tail, data);
+            Indices* next = &header->slots[1 - header->active];
+            next->head = 0;
+            next->tail = n;
+            std::atomic_signal_fence(std::memory_order_release);
+            header->active = 1 - header->active;
+            ind = next;
+            for (size_t i = head; i < tail; ++i) {
+                data[i].~T();
+            }
+        } else {
+            grow(capacity() * 2);
+        }
+    }
+
+    // Extends the file first and then the capacity in its header, so that a
+    // crash in between only leaves unused space at the end of the file. The
+    // old mapping is only removed after the new one is made, so the queue is
+    // still valid when growing fails.
+    void grow(const size_t capacity)
+    {
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) {
+            throw std::bad_alloc();
+        }
+        Header* old_header = header;
+        const size_t old_size = map_size;
+        bool ok = ftruncate(fd, static_cast<off_t>(file_size(capacity))) == 0 && map_file(fd, capacity);
+        ::close(fd);
+        if (!ok) {
+            throw std::bad_alloc();
+        }
+        munmap(old_header, old_size);
+        std::atomic_signal_fence(std::memory_order_release);
+        header->capacity = capacity;
+    }
+
+    Header* header;
+    T* data;
+    Indices* ind;
+    Indices none;
+    size_t map_size;
+    std::string path;
+    bool temporary;
+    size_t sync_interval;
+    size_t unsynced;
+};
+
+#endif // MAPPED_QUEUE_H
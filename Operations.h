@@ -0,0 +1,36 @@
+//
+// Operations.h
+//
+// Flags for the operations a container supports with a reasonable complexity
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef OPERATIONS_H
+#define OPERATIONS_H
+
+// Containers declare the set of operations they can be benchmarked with in a
+// static 'operations' member. An operation may still be available as a method
+// without being listed here (e.g. push_front of StdVector), in which case the
+// tests using it are not run for the container and marked '(NR)' on charts.
+enum Operation {
+    OP_PUSH_BACK = 1 << 0,
+    OP_POP_BACK = 1 << 1,
+    OP_PUSH_FRONT = 1 << 2,
+    OP_POP_FRONT = 1 << 3,
+    OP_RANDOM_ACCESS = 1 << 4,
+    OP_RESERVE_BACK = 1 << 5,
+    OP_RESERVE_FRONT = 1 << 6,
+    OP_LOAD_FACTOR = 1 << 7,
+    OP_SEAM = 1 << 8, // seam() is the index where the second of two arrays starts
+    OP_INSERT = 1 << 9, // insert(pos, val), erase(pos) and erase(first, last) at any index
+    OP_PERSISTENT = 1 << 10, // open(path) keeps elements in a file and set_sync_interval(ops) syncs it, opt-in
+};
+
+constexpr bool supports(const unsigned operations, const unsigned required)
+{
+    return (operations & required) == required;
+}
+
+#endif // OPERATIONS_H
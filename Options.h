@@ -0,0 +1,404 @@
+//
+// Options.h
+//
+// Command line options for selecting tests and controlling parameters
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Stats.h"
+
+struct Options {
+    Options()
+        : scale(1000)
+        , steps(10)
+        , sweep("linear")
+        , output("charts.html")
+        , threshold(0.05)
+        , per_op(false)
+        , assert_complexity(false)
+        , fit_tolerance(2.0)
+        , jobs(1)
+        , one_per_llc(false)
+        , isolate(false)
+        , prewarm(0)
+        , footprint(4 * 1024 * 1024)
+        , threads(0)
+        , churn(1000)
+        , cache_limit(64 * 1024 * 1024)
+        , cache_class_limit(16 * 1024 * 1024)
+        , sync_every(4096)
+    {
+    }
+
+    std::vector<std::string> tests;
+    std::vector<std::string> containers;
+    std::vector<std::string> types;
+    std::vector<size_t> sizes;
+    std::vector<std::string> traces;
+    std::vector<std::string> workloads;
+    size_t scale;
+    size_t steps;
+    std::string sweep;
+    std::string output;
+    std::string json;
+    std::string csv;
+    std::string input;
+    std::string compare;
+    double threshold;
+    bool per_op;
+    bool assert_complexity;
+    double fit_tolerance;
+    size_t jobs;
+    bool one_per_llc;
+    bool isolate;
+    size_t prewarm; // bytes
+    size_t footprint;
+    size_t threads; // most threads of thread tests, 0 for all usable cpus
+    size_t churn;   // live containers of churn tests
+    size_t cache_limit;       // bytes cached per thread in cached tests
+    size_t cache_class_limit; // bytes cached per size class in cached tests
+    size_t sync_every;        // operations between syncs of synced tests
+    RunnerConfig runner;
+};
+
+static std::string to_lower(std::string str)
+{
+    std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+    return str;
+}
+
+static std::vector<std::string> split_list(const std::string& str)
+{
+    std::vector<std::string> res;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            res.push_back(item);
+        }
+    }
+    return res;
+}
+
+// an empty filter selects everything, names are compared case insensitively
+static bool matches(const std::vector<std::string>& filter, const std::string& name)
+{
+    if (filter.empty()) {
+        return true;
+    }
+    for (const auto& item : filter) {
+        if (to_lower(item) == to_lower(name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void print_usage(std::ostream& out, const char* prog)
+{
+    out << "usage: " << prog << " [options]\n"
+        << "\n"
+        << "  -t, --test=LIST             tests to run, e.g. FillBack,QSortLarge\n"
+        << "  -c, --container=LIST        containers to run, e.g. StdVector,DequeNaive\n"
+        << "  -e, --type=LIST             element types to run, e.g. Small,Large\n"
+        << "  -n, --scale=N               base size multiplied per test (default 1000)\n"
+        << "  -s, --steps=K               number of sizes per test (default 10)\n"
+        << "  -z, --sizes=LIST            explicit list of sizes used by all tests\n"
+        << "      --sweep=MODE            'linear' steps or 'cache' boundaries (default linear)\n"
+        << "      --footprint=BYTES       total element bytes of blob tests (default 4194304)\n"
+        << "      --threads=N             most threads of thread tests, 0 for all cpus (default 0)\n"
+        << "      --churn=K               live containers of churn tests (default 1000)\n"
+        << "      --cache-limit=BYTES     buffer bytes cached per thread in cached tests (default 67108864)\n"
+        << "      --cache-class=BYTES     buffer bytes cached per size class (default 16777216)\n"
+        << "      --sync-every=K          operations between syncs of persistent queues (default 4096)\n"
+        << "      --trace=LIST            trace files to replay against all containers\n"
+        << "      --workload=SPEC         workload to generate, can be given more than once\n"
+        << "  -o, --output=PATH           chart output path (default charts.html)\n"
+        << "  -j, --jobs=N                workers pinned to separate cores, 0 for all (default 1)\n"
+        << "      --one-per-llc           use at most one worker per last level cache\n"
+        << "      --isolate               run each measurement in a freshly forked process\n"
+        << "      --prewarm=MB            warm up the heap of isolated processes first\n"
+        << "      --json=PATH             write results with metadata as json\n"
+        << "      --csv=PATH              write results with metadata as csv\n"
+        << "      --compare=PATH          compare results with a baseline json file\n"
+        << "      --threshold=FRACTION    regression threshold for compare (default 0.05)\n"
+        << "      --input=PATH            compare results from a json file instead of running\n"
+        << "      --per-op                plot time per operation instead of total time\n"
+        << "      --assert-complexity     fail if a series grows faster than expected\n"
+        << "      --fit-tolerance=X       error ratio to flag complexity changes (default 2)\n"
+        << "      --min-samples=K         minimum samples per measurement (default 5)\n"
+        << "      --max-samples=K         maximum samples per measurement (default 30)\n"
+        << "      --min-time=MS           minimum time per sample (default 10)\n"
+        << "      --max-time=MS           time budget per measurement (default 2000)\n"
+        << "      --max-wall-time=MS      budget including untimed setup (default 10000)\n"
+        << "      --ci=FRACTION           target relative CI half width (default 0.02)\n"
+        << "  -h, --help                  show this message\n";
+}
+
+// strtoull skips leading spaces and negates after a '-', so only digits are
+// accepted and values out of range are rejected
+static bool parse_size(const char* str, size_t& res)
+{
+    if (!std::isdigit(static_cast<unsigned char>(*str))) {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    unsigned long long val = std::strtoull(str, &end, 10);
+    if (*end != '\0' || errno == ERANGE || val > SIZE_MAX) {
+        return false;
+    }
+    res = static_cast<size_t>(val);
+    return true;
+}
+
+static bool parse_double(const char* str, double& res)
+{
+    char* end;
+    res = std::strtod(str, &end);
+    return *str != '\0' && *end == '\0';
+}
+
+// returns false and prints a message on invalid options
+static bool parse_options(int argc, char** argv, Options& options)
+{
+    enum {
+        OPT_MIN_SAMPLES = 256,
+        OPT_MAX_SAMPLES,
+        OPT_MIN_TIME,
+        OPT_MAX_TIME,
+        OPT_MAX_WALL_TIME,
+        OPT_CI,
+        OPT_JSON,
+        OPT_CSV,
+        OPT_COMPARE,
+        OPT_THRESHOLD,
+        OPT_INPUT,
+        OPT_PER_OP,
+        OPT_ASSERT_COMPLEXITY,
+        OPT_FIT_TOLERANCE,
+        OPT_ONE_PER_LLC,
+        OPT_SWEEP,
+        OPT_TRACE,
+        OPT_WORKLOAD,
+        OPT_ISOLATE,
+        OPT_PREWARM,
+        OPT_FOOTPRINT,
+        OPT_THREADS,
+        OPT_CHURN,
+        OPT_CACHE_LIMIT,
+        OPT_CACHE_CLASS,
+        OPT_SYNC_EVERY,
+    };
+
+    static const struct option long_options[] = {
+        { "test", required_argument, nullptr, 't' },
+        { "container", required_argument, nullptr, 'c' },
+        { "type", required_argument, nullptr, 'e' },
+        { "scale", required_argument, nullptr, 'n' },
+        { "steps", required_argument, nullptr, 's' },
+        { "sizes", required_argument, nullptr, 'z' },
+        { "sweep", required_argument, nullptr, OPT_SWEEP },
+        { "threads", required_argument, nullptr, OPT_THREADS },
+        { "churn", required_argument, nullptr, OPT_CHURN },
+        { "cache-limit", required_argument, nullptr, OPT_CACHE_LIMIT },
+        { "cache-class", required_argument, nullptr, OPT_CACHE_CLASS },
+        { "sync-every", required_argument, nullptr, OPT_SYNC_EVERY },
+        { "trace", required_argument, nullptr, OPT_TRACE },
+        { "footprint", required_argument, nullptr, OPT_FOOTPRINT },
+        { "workload", required_argument, nullptr, OPT_WORKLOAD },
+        { "output", required_argument, nullptr, 'o' },
+        { "jobs", required_argument, nullptr, 'j' },
+        { "one-per-llc", no_argument, nullptr, OPT_ONE_PER_LLC },
+        { "isolate", no_argument, nullptr, OPT_ISOLATE },
+        { "prewarm", required_argument, nullptr, OPT_PREWARM },
+        { "min-samples", required_argument, nullptr, OPT_MIN_SAMPLES },
+        { "max-samples", required_argument, nullptr, OPT_MAX_SAMPLES },
+        { "min-time", required_argument, nullptr, OPT_MIN_TIME },
+        { "max-time", required_argument, nullptr, OPT_MAX_TIME },
+        { "max-wall-time", required_argument, nullptr, OPT_MAX_WALL_TIME },
+        { "ci", required_argument, nullptr, OPT_CI },
+        { "json", required_argument, nullptr, OPT_JSON },
+        { "csv", required_argument, nullptr, OPT_CSV },
+        { "compare", required_argument, nullptr, OPT_COMPARE },
+        { "threshold", required_argument, nullptr, OPT_THRESHOLD },
+        { "input", required_argument, nullptr, OPT_INPUT },
+        { "per-op", no_argument, nullptr, OPT_PER_OP },
+        { "assert-complexity", no_argument, nullptr, OPT_ASSERT_COMPLEXITY },
+        { "fit-tolerance", required_argument, nullptr, OPT_FIT_TOLERANCE },
+        { "help", no_argument, nullptr, 'h' },
+        { nullptr, 0, nullptr, 0 },
+    };
+
+    int opt;
+    bool ok = true;
+    while (ok && (opt = getopt_long(argc, argv, "t:c:e:n:s:z:o:j:h", long_options, nullptr)) != -1) {
+        switch (opt) {
+        case 't':
+            options.tests = split_list(optarg);
+            break;
+        case 'c':
+            options.containers = split_list(optarg);
+            break;
+        case 'e':
+            options.types = split_list(optarg);
+            break;
+        case 'n':
+            ok = parse_size(optarg, options.scale) && options.scale > 0;
+            break;
+        case 's':
+            ok = parse_size(optarg, options.steps) && options.steps > 0;
+            break;
+        case 'z':
+            options.sizes.clear();
+            for (const auto& item : split_list(optarg)) {
+                size_t size;
+                ok = ok && parse_size(item.c_str(), size) && size > 0;
+                options.sizes.push_back(size);
+            }
+            break;
+        case OPT_SWEEP:
+            options.sweep = to_lower(optarg);
+            ok = options.sweep == "linear" || options.sweep == "cache";
+            break;
+        case OPT_FOOTPRINT:
+            ok = parse_size(optarg, options.footprint) && options.footprint > 0;
+            break;
+        case OPT_THREADS:
+            ok = parse_size(optarg, options.threads);
+            break;
+        case OPT_CHURN:
+            ok = parse_size(optarg, options.churn) && options.churn > 0;
+            break;
+        case OPT_CACHE_LIMIT:
+            ok = parse_size(optarg, options.cache_limit);
+            break;
+        case OPT_CACHE_CLASS:
+            ok = parse_size(optarg, options.cache_class_limit);
+            break;
+        case OPT_SYNC_EVERY:
+            ok = parse_size(optarg, options.sync_every) && options.sync_every > 0;
+            break;
+        case OPT_TRACE:
+            options.traces = split_list(optarg);
+            break;
+        case OPT_WORKLOAD:
+            options.workloads.push_back(optarg);
+            break;
+        case 'o':
+            options.output = optarg;
+            break;
+        case 'j':
+            ok = parse_size(optarg, options.jobs);
+            break;
+        case OPT_ONE_PER_LLC:
+            options.one_per_llc = true;
+            break;
+        case OPT_ISOLATE:
+            options.isolate = true;
+            break;
+        case OPT_PREWARM:
+            ok = parse_size(optarg, options.prewarm) && options.prewarm <= SIZE_MAX / (1024 * 1024);
+            if (ok) {
+                options.prewarm *= 1024 * 1024;
+            }
+            break;
+        case OPT_MIN_SAMPLES:
+            ok = parse_size(optarg, options.runner.min_samples) && options.runner.min_samples > 0;
+            break;
+        case OPT_MAX_SAMPLES:
+            ok = parse_size(optarg, options.runner.max_samples) && options.runner.max_samples > 0;
+            break;
+        case OPT_MIN_TIME:
+            ok = parse_double(optarg, options.runner.min_time) && options.runner.min_time >= 0;
+            break;
+        case OPT_MAX_TIME:
+            ok = parse_double(optarg, options.runner.max_time) && options.runner.max_time >= 0;
+            break;
+        case OPT_MAX_WALL_TIME:
+            ok = parse_double(optarg, options.runner.max_wall_time) && options.runner.max_wall_time >= 0;
+            break;
+        case OPT_CI:
+            ok = parse_double(optarg, options.runner.target_ci) && options.runner.target_ci > 0;
+            break;
+        case OPT_JSON:
+            options.json = optarg;
+            break;
+        case OPT_CSV:
+            options.csv = optarg;
+            break;
+        case OPT_COMPARE:
+            options.compare = optarg;
+            break;
+        case OPT_THRESHOLD:
+            ok = parse_double(optarg, options.threshold) && options.threshold >= 0;
+            break;
+        case OPT_INPUT:
+            options.input = optarg;
+            break;
+        case OPT_PER_OP:
+            options.per_op = true;
+            break;
+        case OPT_ASSERT_COMPLEXITY:
+            options.assert_complexity = true;
+            break;
+        case OPT_FIT_TOLERANCE:
+            ok = parse_double(optarg, options.fit_tolerance) && options.fit_tolerance >= 1;
+            break;
+        case 'h':
+            print_usage(std::cout, argv[0]);
+            std::exit(EXIT_SUCCESS);
+        default:
+            print_usage(std::cerr, argv[0]);
+            return false;
+        }
+        if (!ok) {
+            std::cerr << argv[0] << ": invalid argument '" << optarg << "'" << std::endl;
+        }
+    }
+
+    if (ok && optind < argc) {
+        std::cerr << argv[0] << ": unexpected argument '" << argv[optind] << "'" << std::endl;
+        ok = false;
+    }
+    if (ok && options.runner.min_samples > options.runner.max_samples) {
+        std::cerr << argv[0] << ": min-samples is larger than max-samples" << std::endl;
+        ok = false;
+    }
+
+    if (ok && !options.sizes.empty() && options.sweep != "linear") {
+        std::cerr << argv[0] << ": sizes can not be used with a " << options.sweep << " sweep" << std::endl;
+        ok = false;
+    }
+
+    if (ok && options.prewarm > 0 && !options.isolate) {
+        std::cerr << argv[0] << ": prewarm is only used with isolate" << std::endl;
+        ok = false;
+    }
+
+    if (ok && !options.input.empty() && options.compare.empty()) {
+        std::cerr << argv[0] << ": input is only used with compare" << std::endl;
+        ok = false;
+    }
+
+    return ok;
+}
+
+#endif // OPTIONS_H
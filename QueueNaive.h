@@ -13,20 +13,31 @@
 #include <algorithm>
 #include <iostream>
 
+#include "BufferCache.h"
+#include "Operations.h"
+
 template <typename T>
 class QueueNaive {
 public:
+    static const char* name() { return "QueueNaive"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_POP_FRONT |
+                                       OP_RANDOM_ACCESS | OP_RESERVE_BACK |
+                                       OP_RESERVE_FRONT | OP_LOAD_FACTOR |
+                                       OP_INSERT;
+
     QueueNaive()
         : capacity(1)
         , size(0)
         , offset(0)
     {
-        data = new T[capacity];
+        data = buffer_new<T>(capacity);
     }
 
-    ~QueueNaive() { delete[] data; }
+    ~QueueNaive() { buffer_delete(data); }
 
     T& operator[](size_t ind) { return data[ind + offset]; }
+    T& front() { return data[offset]; }
+    T& back() { return data[offset + size - 1]; }
 
     float load_factor() { return static_cast<float>(size) / capacity; }
 
@@ -34,9 +45,9 @@ public:
     {
         if (n + offset > capacity) {
             capacity = n + offset;
-            T* new_data = new T[capacity];
+            T* new_data = buffer_new<T>(capacity);
             std::copy(data + offset, data + offset + size, new_data + offset);
-            delete[] data;
+            buffer_delete(data);
             data = new_data;
         }
     }
@@ -46,9 +57,9 @@ public:
         if (n > size + offset) {
             capacity += n - (size + offset);
             offset = n - size;
-            T* new_data = new T[capacity];
+            T* new_data = buffer_new<T>(capacity);
             std::copy(data + offset, data + offset + size, new_data + offset);
-            delete[] data;
+            buffer_delete(data);
             data = new_data;
         }
     }
@@ -57,9 +68,9 @@ public:
     {
         if (size + offset >= capacity) {
             capacity *= 2;
-            T* new_data = new T[capacity];
+            T* new_data = buffer_new<T>(capacity);
             std::copy(data + offset, data + offset + size, new_data + offset);
-            delete[] data;
+            buffer_delete(data);
             data = new_data;
         }
         data[size + offset] = val;
@@ -77,9 +88,9 @@ public:
         } else {
             if (size >= capacity) {
                 capacity *= 2;
-                T* new_data = new T[capacity];
+                T* new_data = buffer_new<T>(capacity);
                 std::copy(data, data + size, new_data + 1);
-                delete[] data;
+                buffer_delete(data);
                 data = new_data;
             } else {
                 std::move_backward(data, data + size, data + size + 1);
@@ -95,6 +106,40 @@ public:
         offset++;
     }
 
+    // Inserts before index pos, moving the elements before it into the space
+    // in front when that side is shorter, or the elements after it otherwise.
+    void insert(size_t pos, const T& val)
+    {
+        if (offset > 0 && (pos < size - pos || size + offset >= capacity)) {
+            std::move(data + offset, data + offset + pos, data + offset - 1);
+            offset--;
+            size++;
+            data[offset + pos] = val;
+        } else if (pos == size) {
+            push_back(val);
+        } else {
+            push_back(val);
+            std::move_backward(data + offset + pos,
+                               data + offset + size - 1,
+                               data + offset + size);
+            data[offset + pos] = val;
+        }
+    }
+
+    void erase(size_t pos) { erase(pos, pos + 1); }
+
+    // erases indices from first to last - 1 moving the shorter side
+    void erase(size_t first, size_t last)
+    {
+        if (first < size - last) {
+            std::move_backward(data + offset, data + offset + first, data + offset + last);
+            offset += last - first;
+        } else {
+            std::move(data + offset + last, data + offset + size, data + offset + first);
+        }
+        size -= last - first;
+    }
+
     void draw()
     {
         std::cout << "|";
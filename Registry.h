@@ -0,0 +1,112 @@
+//
+// Registry.h
+//
+// Compile-time lists of containers and element types to run tests over
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <cstdlib>
+
+#include "Complexity.h"
+#include "Operations.h"
+
+template <template <typename> class... Containers>
+struct ContainerList {
+};
+
+template <typename... Types>
+struct TypeList {
+};
+
+template <template <typename> class Container>
+struct ContainerTag {
+};
+
+template <typename Type>
+struct TypeTag {
+};
+
+// calls f(ContainerTag<Container>()) for each container in the list in order
+template <typename Function>
+void for_each_container(ContainerList<>, Function&)
+{
+}
+
+template <template <typename> class Head, template <typename> class... Tail, typename Function>
+void for_each_container(ContainerList<Head, Tail...>, Function& f)
+{
+    f(ContainerTag<Head>());
+    for_each_container(ContainerList<Tail...>(), f);
+}
+
+// calls f(TypeTag<Type>()) for each type in the list in order
+template <typename Function>
+void for_each_type(TypeList<>, Function&)
+{
+}
+
+template <typename Head, typename... Tail, typename Function>
+void for_each_type(TypeList<Head, Tail...>, Function& f)
+{
+    f(TypeTag<Head>());
+    for_each_type(TypeList<Tail...>(), f);
+}
+
+// Kernels describe a test with a name, the operations it requires and a static
+// run<Container, Type>(n) method. A container that does not support a kernel
+// runs its fallback instead, which ends with NotRun for '(NR)' columns. The
+// number of operations and the expected complexity of run(n) are used for the
+// per operation metrics and the complexity assertions.
+struct NotRun {
+    static const unsigned required = 0;
+    static const unsigned opt_in = 0;
+};
+
+struct Kernel {
+    typedef NotRun fallback;
+    static const size_t max_scale = 100;
+    static const size_t max_elements = 0; // largest size of cache sweeps, 0 for no limit
+    static const unsigned opt_in = 0;     // opt-in operations accepted without being required
+    static const Complexity expected = O_N;
+
+    static double operations(const size_t n) { return static_cast<double>(n); }
+
+    // metric of memory kernels, i.e. load factors unless they measure otherwise
+    static const char* metric() { return "load"; }
+
+    // frees data generated once for the repeated calls of a measurement
+    static void release() {}
+};
+
+// Containers with OP_PERSISTENT keep their elements in files, which makes
+// constructing them expensive, so they only run kernels requiring the flag or
+// listing it in opt_in.
+constexpr bool runs(const unsigned operations, const unsigned required, const unsigned opt_in)
+{
+    return supports(operations, required) &&
+           ((operations & OP_PERSISTENT) == 0 || ((required | opt_in) & OP_PERSISTENT) != 0);
+}
+
+template <typename K, template <typename> class Container,
+          bool = runs(Container<char>::operations, K::required, K::opt_in)>
+struct Resolve {
+    typedef K type;
+};
+
+template <typename K, template <typename> class Container>
+struct Resolve<K, Container, false> {
+    typedef typename Resolve<typename K::fallback, Container>::type type;
+};
+
+// containers that do not run NotRun either, i.e. persistent ones, end there too
+template <template <typename> class Container>
+struct Resolve<NotRun, Container, false> {
+    typedef NotRun type;
+};
+
+#endif // REGISTRY_H
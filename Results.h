@@ -0,0 +1,486 @@
+//
+// Results.h
+//
+// Result records with run metadata, json/csv output and baseline comparison
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <sys/utsname.h>
+
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <json/json.h>
+
+#include "Complexity.h"
+#include "Counted.h"
+#include "Stats.h"
+
+#ifndef BENCH_CXXFLAGS
+#define BENCH_CXXFLAGS "unknown"
+#endif
+
+#ifndef BENCH_GIT_HASH
+#define BENCH_GIT_HASH "unknown"
+#endif
+
+struct Result {
+    std::string test;
+    std::string type;
+    std::string container;
+    size_t n;
+    size_t threads;     // threads running the test at once, each on its own container
+    std::string metric; // "ms" for timings, otherwise the metric of memory tests
+    double ops;         // container operations per measured call
+    int expected;       // expected Complexity of timings, -1 if unknown
+    Measurement m;
+    bool counted;         // whether counts are known, i.e. for instrumented types
+    ElementCounts counts; // element operations of a single measured call
+
+    Result()
+        : n(0)
+        , threads(1)
+        , ops(0)
+        , expected(-1)
+        , counted(false)
+        , counts()
+    {
+    }
+
+    double ns_per_op() const { return ops > 0 ? m.median * 1e6 / ops : 0; }
+    double ops_per_sec() const { return m.median > 0 ? ops / (m.median / 1e3) : 0; }
+
+    // single threaded keys are kept as they were before thread tests
+    std::string key() const
+    {
+        std::string str = test + "/" + type + "/" + container + "/" + std::to_string(n);
+        if (threads > 1) {
+            str += "x" + std::to_string(threads);
+        }
+        return str + "/" + metric;
+    }
+};
+
+typedef std::map<std::string, std::string> Metadata;
+
+static std::string cpu_model()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t pos = line.find(':');
+            if (pos != std::string::npos && pos + 2 <= line.size()) {
+                return line.substr(pos + 2);
+            }
+        }
+    }
+    return "unknown";
+}
+
+static Metadata collect_metadata()
+{
+    Metadata meta;
+
+    meta["cpu"] = cpu_model();
+#if defined(__clang__)
+    meta["compiler"] = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    meta["compiler"] = "gcc " __VERSION__;
+#else
+    meta["compiler"] = "unknown";
+#endif
+    meta["flags"] = BENCH_CXXFLAGS;
+    meta["git"] = BENCH_GIT_HASH;
+
+    struct utsname uts;
+    if (uname(&uts) == 0) {
+        meta["host"] = uts.nodename;
+        meta["kernel"] = std::string(uts.sysname) + " " + uts.release;
+    }
+
+    char buf[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    meta["timestamp"] = buf;
+
+    return meta;
+}
+
+static void write_results_json(std::ostream& out, const Metadata& meta, const std::vector<Result>& results)
+{
+    Json::Value root;
+    for (const auto& item : meta) {
+        root["metadata"][item.first] = item.second;
+    }
+    root["results"] = Json::Value(Json::arrayValue);
+    for (const auto& r : results) {
+        Json::Value v;
+        v["test"] = r.test;
+        v["type"] = r.type;
+        v["container"] = r.container;
+        v["n"] = static_cast<Json::UInt64>(r.n);
+        v["threads"] = static_cast<Json::UInt64>(r.threads);
+        v["metric"] = r.metric;
+        v["median"] = r.m.median;
+        v["mad"] = r.m.mad;
+        v["mean"] = r.m.mean;
+        v["ci_low"] = r.m.ci_low;
+        v["ci_high"] = r.m.ci_high;
+        v["samples"] = static_cast<Json::UInt64>(r.m.samples);
+        v["iterations"] = static_cast<Json::UInt64>(r.m.iterations);
+        v["unstable"] = r.m.unstable;
+        v["ops"] = r.ops;
+        v["ns_per_op"] = r.ns_per_op();
+        v["ops_per_sec"] = r.ops_per_sec();
+        if (r.expected >= 0) {
+            v["expected"] = complexity_name(static_cast<Complexity>(r.expected));
+        }
+        if (r.counted) {
+            v["counts"]["default_constructs"] = static_cast<Json::UInt64>(r.counts.default_constructs);
+            v["counts"]["copy_constructs"] = static_cast<Json::UInt64>(r.counts.copy_constructs);
+            v["counts"]["copy_assigns"] = static_cast<Json::UInt64>(r.counts.copy_assigns);
+            v["counts"]["move_constructs"] = static_cast<Json::UInt64>(r.counts.move_constructs);
+            v["counts"]["move_assigns"] = static_cast<Json::UInt64>(r.counts.move_assigns);
+            v["counts"]["destructs"] = static_cast<Json::UInt64>(r.counts.destructs);
+        }
+        root["results"].append(v);
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    out << Json::writeString(builder, root) << std::endl;
+}
+
+// metadata goes into leading comment lines so the rest is a plain csv table,
+// element counts are left empty for types that are not instrumented
+static void write_results_csv(std::ostream& out, const Metadata& meta, const std::vector<Result>& results)
+{
+    for (const auto& item : meta) {
+        out << "# " << item.first << ": " << item.second << std::endl;
+    }
+    out << "test,type,container,n,threads,metric,median,mad,mean,ci_low,ci_high,samples,iterations,unstable,"
+           "ops,ns_per_op,ops_per_sec,default_constructs,copy_constructs,copy_assigns,"
+           "move_constructs,move_assigns,destructs"
+        << std::endl;
+    for (const auto& r : results) {
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%.9g,%.9g,%.9g,%.9g,%.9g,%zu,%zu,%d,%.9g,%.9g,%.9g",
+                 r.m.median, r.m.mad, r.m.mean, r.m.ci_low, r.m.ci_high,
+                 r.m.samples, r.m.iterations, r.m.unstable ? 1 : 0,
+                 r.ops, r.ns_per_op(), r.ops_per_sec());
+        out << r.test << "," << r.type << "," << r.container << "," << r.n << ","
+            << r.threads << "," << r.metric << "," << buf;
+        if (r.counted) {
+            out << "," << r.counts.default_constructs << "," << r.counts.copy_constructs
+                << "," << r.counts.copy_assigns << "," << r.counts.move_constructs
+                << "," << r.counts.move_assigns << "," << r.counts.destructs << std::endl;
+        } else {
+            out << ",,,,,," << std::endl;
+        }
+    }
+}
+
+// returns false and prints a message if the file can not be read
+static bool read_results_json(const std::string& path, Metadata& meta, std::vector<Result>& results)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open results file '" << path << "'" << std::endl;
+        return false;
+    }
+
+    Json::CharReaderBuilder builder;
+    Json::Value root;
+    std::string errors;
+    if (!Json::parseFromStream(builder, in, &root, &errors)) {
+        std::cerr << "cannot parse results file '" << path << "': " << errors << std::endl;
+        return false;
+    }
+
+    for (const auto& name : root["metadata"].getMemberNames()) {
+        meta[name] = root["metadata"][name].asString();
+    }
+    for (const auto& v : root["results"]) {
+        Result r;
+        r.test = v["test"].asString();
+        r.type = v["type"].asString();
+        r.container = v["container"].asString();
+        r.n = static_cast<size_t>(v["n"].asUInt64());
+        r.threads = static_cast<size_t>(v.get("threads", 1).asUInt64());
+        r.metric = v["metric"].asString();
+        r.m.median = v["median"].asDouble();
+        r.m.mad = v["mad"].asDouble();
+        r.m.mean = v["mean"].asDouble();
+        r.m.ci_low = v["ci_low"].asDouble();
+        r.m.ci_high = v["ci_high"].asDouble();
+        r.m.samples = static_cast<size_t>(v["samples"].asUInt64());
+        r.m.iterations = static_cast<size_t>(v["iterations"].asUInt64());
+        r.m.unstable = v["unstable"].asBool();
+        r.ops = v["ops"].asDouble();
+        for (int c = 0; c < COMPLEXITY_COUNT; ++c) {
+            if (v["expected"].asString() == complexity_name(static_cast<Complexity>(c))) {
+                r.expected = c;
+            }
+        }
+        const Json::Value& counts = v["counts"];
+        if (counts.isObject()) {
+            r.counted = true;
+            r.counts.default_constructs = static_cast<size_t>(counts["default_constructs"].asUInt64());
+            r.counts.copy_constructs = static_cast<size_t>(counts["copy_constructs"].asUInt64());
+            r.counts.copy_assigns = static_cast<size_t>(counts["copy_assigns"].asUInt64());
+            r.counts.move_constructs = static_cast<size_t>(counts["move_constructs"].asUInt64());
+            r.counts.move_assigns = static_cast<size_t>(counts["move_assigns"].asUInt64());
+            r.counts.destructs = static_cast<size_t>(counts["destructs"].asUInt64());
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
+// Compares results with a baseline and returns the number of regressions. A
+// timing is a regression when its median is slower by more than threshold and
+// its confidence interval does not overlap with the one of the baseline.
+static size_t compare_results(const Metadata& base_meta,
+                              const std::vector<Result>& baseline,
+                              const std::vector<Result>& results,
+                              const double threshold)
+{
+    std::map<std::string, const Result*> base;
+    for (const auto& r : baseline) {
+        base[r.key()] = &r;
+    }
+
+    std::cout << "comparing with baseline "
+              << (base_meta.count("git") ? base_meta.at("git") : "unknown") << " from "
+              << (base_meta.count("timestamp") ? base_meta.at("timestamp") : "unknown")
+              << std::endl;
+
+    size_t regressions = 0;
+    size_t improvements = 0;
+    size_t matched = 0;
+    for (const auto& r : results) {
+        auto it = base.find(r.key());
+        if (it == base.end() || it->second->m.median <= 0) {
+            continue;
+        }
+        const Result& b = *it->second;
+        matched++;
+
+        double delta = (r.m.median - b.m.median) / b.m.median;
+        bool slower = r.m.ci_low > b.m.ci_high;
+        bool faster = r.m.ci_high < b.m.ci_low;
+        bool significant = slower || faster;
+
+        const char* verdict = "";
+        if (r.metric == "ms" && significant && std::fabs(delta) > threshold) {
+            if (slower) {
+                verdict = " REGRESSION";
+                regressions++;
+            } else {
+                verdict = " improvement";
+                improvements++;
+            }
+        } else if (!significant) {
+            verdict = " (not significant)";
+        }
+
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%-24s %-18s n=%-9zu %10.4g -> %-10.4g %+7.2f%%",
+                 (r.test + r.type).c_str(), r.container.c_str(), r.n,
+                 b.m.median, r.m.median, delta * 100);
+        std::cout << buf << verdict << std::endl;
+    }
+
+    std::cout << matched << " results compared, " << regressions << " regressions and "
+              << improvements << " improvements above " << threshold * 100 << "%" << std::endl;
+    return regressions;
+}
+
+// prints the element counts of the largest size of each counted series
+static void report_counts(const std::vector<Result>& results)
+{
+    std::vector<std::string> order;
+    std::map<std::string, const Result*> largest;
+    for (const auto& r : results) {
+        if (!r.counted) {
+            continue;
+        }
+        std::string key = r.test + "/" + r.type + "/" + r.container;
+        auto it = largest.find(key);
+        if (it == largest.end()) {
+            order.push_back(key);
+            largest[key] = &r;
+        } else if (r.n > it->second->n) {
+            it->second = &r;
+        }
+    }
+
+    for (const auto& key : order) {
+        const Result& r = *largest[key];
+        const ElementCounts& c = r.counts;
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%-24s %-18s n=%-9zu default=%-9zu copy=%-9zu move=%-9zu destruct=%zu",
+                 (r.test + r.type).c_str(), r.container.c_str(), r.n,
+                 c.default_constructs, c.copies(), c.moves(), c.destructs);
+        std::cout << buf << std::endl;
+    }
+}
+
+// Prints the throughput per thread and the scaling efficiency of each series
+// run in more than one thread. Efficiency is the throughput per thread over
+// the throughput with a single thread, so it stays at 1 unless threads slow
+// each other down, whether each thread has a container of its own or threads
+// split the work on a single container.
+static void report_scaling(const std::vector<Result>& results)
+{
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<const Result*>> series;
+    for (const auto& r : results) {
+        if (r.metric != "ms") {
+            continue;
+        }
+        std::string key = r.test + "/" + r.type + "/" + r.container + "/" + std::to_string(r.n);
+        if (series.find(key) == series.end()) {
+            order.push_back(key);
+        }
+        series[key].push_back(&r);
+    }
+
+    for (const auto& key : order) {
+        const std::vector<const Result*>& rs = series[key];
+        double single = 0;
+        bool threaded = false;
+        for (const Result* r : rs) {
+            if (r->threads == 1) {
+                single = r->ops_per_sec();
+            }
+            threaded = threaded || r->threads > 1;
+        }
+        if (!threaded) {
+            continue;
+        }
+        for (const Result* r : rs) {
+            char buf[256];
+            snprintf(buf, sizeof(buf), "%-24s %-18s threads=%-4zu %10.4g ops/s per thread",
+                     (r->test + r->type).c_str(), r->container.c_str(), r->threads,
+                     r->ops_per_sec() / r->threads);
+            std::cout << buf;
+            if (single > 0) {
+                snprintf(buf, sizeof(buf), "  efficiency %.2f", r->ops_per_sec() / r->threads / single);
+                std::cout << buf;
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+struct SeriesFit {
+    std::string test;
+    std::string type;
+    std::string container;
+    int expected;
+    Fit fit;
+};
+
+// Fits the timing series of each test, type and container with at least three
+// distinct sizes against their numbers of operations, which are not
+// proportional to the size for some tests (e.g. window and depth tests run a
+// minimum number of operations at small sizes). Results without operations
+// from older files are fitted against the size.
+static std::vector<SeriesFit> fit_results(const std::vector<Result>& results)
+{
+    std::vector<std::string> order;
+    std::map<std::string, std::vector<const Result*>> series;
+    for (const auto& r : results) {
+        if (r.metric != "ms") {
+            continue;
+        }
+        std::string key = r.test + "/" + r.type + "/" + r.container;
+        if (series.find(key) == series.end()) {
+            order.push_back(key);
+        }
+        series[key].push_back(&r);
+    }
+
+    std::vector<SeriesFit> fits;
+    for (const auto& key : order) {
+        const auto& rs = series[key];
+        std::vector<double> ns;
+        std::vector<double> xs;
+        std::vector<double> ts;
+        for (const Result* r : rs) {
+            ns.push_back(static_cast<double>(r->n));
+            xs.push_back(r->ops > 0 ? r->ops : static_cast<double>(r->n));
+            ts.push_back(r->m.median);
+        }
+        if (std::set<double>(ns.begin(), ns.end()).size() < 3) {
+            continue;
+        }
+
+        SeriesFit sf;
+        sf.test = rs[0]->test;
+        sf.type = rs[0]->type;
+        sf.container = rs[0]->container;
+        sf.expected = rs[0]->expected;
+        sf.fit = fit_complexity(xs, ts);
+        fits.push_back(sf);
+    }
+    return fits;
+}
+
+// Prints the best fitting complexity of each series and returns the number of
+// flagged series. A series is flagged when the expected complexity, or the
+// one fitted for the baseline if given, explains it more than tolerance times
+// worse than the best fit of a different class.
+static size_t report_complexity(const std::vector<Result>& results,
+                                const std::vector<Result>& baseline,
+                                const double tolerance,
+                                size_t& changes)
+{
+    std::map<std::string, Fit> base;
+    for (const auto& sf : fit_results(baseline)) {
+        base[sf.test + sf.type + "/" + sf.container] = sf.fit;
+    }
+
+    size_t violations = 0;
+    changes = 0;
+    for (const auto& sf : fit_results(results)) {
+        const Fit& fit = sf.fit;
+        std::string flags;
+
+        if (sf.expected >= 0 && fit.best > sf.expected &&
+            fit.ratio(static_cast<Complexity>(sf.expected)) > tolerance) {
+            flags += std::string(" ASSERTION expected ") +
+                     complexity_name(static_cast<Complexity>(sf.expected));
+            violations++;
+        }
+
+        auto it = base.find(sf.test + sf.type + "/" + sf.container);
+        if (it != base.end() && it->second.best != fit.best && fit.ratio(it->second.best) > tolerance) {
+            flags += std::string(" CHANGED from ") + complexity_name(it->second.best);
+            changes++;
+        }
+
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%-24s %-18s %-10s c=%-10.4g err=%.3f",
+                 (sf.test + sf.type).c_str(), sf.container.c_str(),
+                 complexity_name(fit.best), fit.coefficient[fit.best], fit.error[fit.best]);
+        std::cout << buf << flags << std::endl;
+    }
+    return violations;
+}
+
+#endif // RESULTS_H
@@ -0,0 +1,267 @@
+//
+// Scheduler.h
+//
+// Runs independent measurements in worker processes pinned to separate cpus
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <malloc.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "Topology.h"
+
+inline bool read_full(const int fd, void* buf, const size_t len)
+{
+    char* p = static_cast<char*>(buf);
+    size_t done = 0;
+    while (done < len) {
+        ssize_t r = read(fd, p + done, len - done);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(r);
+    }
+    return true;
+}
+
+inline bool write_full(const int fd, const void* buf, const size_t len)
+{
+    const char* p = static_cast<const char*>(buf);
+    size_t done = 0;
+    while (done < len) {
+        ssize_t r = write(fd, p + done, len - done);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(r);
+    }
+    return true;
+}
+
+// Runs work() in a freshly forked child and stores its result, so that work
+// starts from the allocator state of the caller instead of the one left behind
+// by previous work. Returns false if the child dies or a pipe fails.
+template <typename R, typename Work>
+bool run_isolated(Work work, R& result)
+{
+    static_assert(std::is_trivially_copyable<R>::value, "results are sent over pipes as bytes");
+
+    std::cout << std::flush;
+    std::cerr << std::flush;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        R r = work();
+        bool ok = write_full(fds[1], &r, sizeof(r));
+        std::cout << std::flush;
+        _exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    bool ok = read_full(fds[0], &result, sizeof(result));
+    close(fds[0]);
+    int status;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return ok;
+}
+
+// Allocates, touches and frees blocks of up to 64K bytes in a fixed pattern
+// until the given number of bytes, and keeps the freed memory in the heap so
+// that later allocations find warm pages. Running this first makes isolated
+// children start from identical warm heaps.
+inline void prewarm_heap(const size_t bytes)
+{
+    mallopt(M_TRIM_THRESHOLD, static_cast<int>(bytes < (1u << 30) ? 2 * bytes : (1u << 31) - 1));
+
+    std::vector<void*> blocks;
+    size_t total = 0;
+    for (size_t size = 64; total < bytes; size = size < 65536 ? size * 2 : 64) {
+        void* p = std::malloc(size);
+        if (!p) {
+            break;
+        }
+        std::memset(p, 0, size);
+        blocks.push_back(p);
+        total += size;
+    }
+    for (size_t i = blocks.size(); i > 0; --i) {
+        std::free(blocks[i - 1]);
+    }
+}
+
+struct Worker {
+    pid_t pid;
+    int task_fd;   // parent writes task indices
+    int result_fd; // parent reads task index and result pairs
+    bool busy;
+};
+
+// closes the pipes of the workers, which makes idle workers exit, and waits
+// for them
+inline void stop_workers(const std::vector<Worker>& workers)
+{
+    for (const auto& w : workers) {
+        close(w.task_fd);
+        close(w.result_fd);
+        waitpid(w.pid, nullptr, 0);
+    }
+}
+
+// Runs work(i) for each i in [0, count) in one worker process per cpu, each
+// pinned to its cpu, and calls done(i, result) in the parent as results come
+// in. Tasks are handed out one at a time so that workers stay balanced even
+// when the measurements take very different times. Workers are forked from the
+// caller, so work can use any state prepared before the call, and results are
+// copied back over pipes. Returns false if a worker dies or a pipe fails.
+template <typename R, typename Work, typename Done>
+bool run_workers(const size_t count, const std::vector<int>& cpus, Work work, Done done)
+{
+    static_assert(std::is_trivially_copyable<R>::value, "results are sent over pipes as bytes");
+
+    std::cout << std::flush;
+    std::cerr << std::flush;
+
+    std::vector<Worker> workers;
+    for (const int cpu : cpus) {
+        int task[2];
+        int result[2];
+        if (pipe(task) != 0) {
+            stop_workers(workers);
+            return false;
+        }
+        if (pipe(result) != 0) {
+            close(task[0]);
+            close(task[1]);
+            stop_workers(workers);
+            return false;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(task[0]);
+            close(task[1]);
+            close(result[0]);
+            close(result[1]);
+            stop_workers(workers);
+            return false;
+        }
+        if (pid == 0) {
+            for (const auto& w : workers) {
+                close(w.task_fd);
+                close(w.result_fd);
+            }
+            close(task[1]);
+            close(result[0]);
+            if (!pin_to_cpu(cpu)) {
+                std::cerr << "cannot pin worker to cpu " << cpu << std::endl;
+            }
+            size_t index;
+            while (read_full(task[0], &index, sizeof(index))) {
+                R r = work(index);
+                if (!write_full(result[1], &index, sizeof(index)) ||
+                    !write_full(result[1], &r, sizeof(r))) {
+                    break;
+                }
+            }
+            std::cout << std::flush;
+            _exit(EXIT_SUCCESS);
+        }
+
+        close(task[0]);
+        close(result[1]);
+        Worker w = { pid, task[1], result[0], false };
+        workers.push_back(w);
+    }
+
+    bool ok = true;
+    size_t next = 0;
+    size_t finished = 0;
+    for (auto& w : workers) {
+        if (next < count && write_full(w.task_fd, &next, sizeof(next))) {
+            w.busy = true;
+            next++;
+        }
+    }
+
+    while (ok && finished < count) {
+        std::vector<pollfd> fds;
+        std::vector<Worker*> polled;
+        for (auto& w : workers) {
+            if (w.busy) {
+                pollfd p = { w.result_fd, POLLIN, 0 };
+                fds.push_back(p);
+                polled.push_back(&w);
+            }
+        }
+        if (fds.empty()) {
+            ok = false;
+            break;
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i].revents == 0) {
+                continue;
+            }
+            Worker& w = *polled[i];
+            size_t index;
+            R r;
+            if (!read_full(w.result_fd, &index, sizeof(index)) || !read_full(w.result_fd, &r, sizeof(r))) {
+                std::cerr << "benchmark worker " << w.pid << " died" << std::endl;
+                w.busy = false;
+                ok = false;
+                continue;
+            }
+            done(index, r);
+            finished++;
+            w.busy = false;
+            if (next < count && write_full(w.task_fd, &next, sizeof(next))) {
+                w.busy = true;
+                next++;
+            }
+        }
+    }
+
+    stop_workers(workers);
+    return ok;
+}
+
+#endif // SCHEDULER_H
@@ -0,0 +1,175 @@
+//
+// Stats.h
+//
+// Adaptive measurement runner and robust summary statistics
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+struct RunnerConfig {
+    RunnerConfig()
+        : min_time(10.0)
+        , max_time(2000.0)
+        , max_wall_time(10000.0)
+        , min_samples(5)
+        , max_samples(30)
+        , target_ci(0.02)
+    {
+    }
+
+    double min_time;    // minimum measured time per sample (ms)
+    double max_time;    // time budget per measurement (ms)
+    double max_wall_time; // budget including untimed setup of the calls (ms)
+    size_t min_samples;
+    size_t max_samples;
+    double target_ci;   // relative half width of the 95% CI of the median
+};
+
+struct Measurement {
+    Measurement()
+        : median(0)
+        , mad(0)
+        , mean(0)
+        , ci_low(0)
+        , ci_high(0)
+        , samples(0)
+        , iterations(0)
+        , unstable(false)
+    {
+    }
+
+    double median;
+    double mad;
+    double mean;
+    double ci_low;
+    double ci_high;
+    size_t samples;
+    size_t iterations;
+    bool unstable;
+
+    double relative_ci() const
+    {
+        return median > 0 ? (ci_high - ci_low) / (2 * median) : 0;
+    }
+};
+
+inline double median_of(std::vector<double> values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    if (values.size() % 2 == 0) {
+        return (values[mid - 1] + values[mid]) / 2;
+    }
+    return values[mid];
+}
+
+// median absolute deviation
+inline double mad_of(const std::vector<double>& values, const double median)
+{
+    std::vector<double> deviations;
+    for (const double value : values) {
+        deviations.push_back(std::fabs(value - median));
+    }
+    return median_of(deviations);
+}
+
+// distribution-free 95% confidence interval of the median using order
+// statistics, which does not assume normally distributed timings
+inline void median_ci(std::vector<double> values, double& low, double& high)
+{
+    std::sort(values.begin(), values.end());
+    const double n = static_cast<double>(values.size());
+    const double spread = 1.96 * std::sqrt(n) / 2;
+    long lo = std::lround(n / 2 - spread) - 1;
+    long hi = std::lround(1 + n / 2 + spread) - 1;
+    lo = std::max(lo, 0L);
+    hi = std::min(hi, static_cast<long>(values.size()) - 1);
+    low = values[lo];
+    high = values[hi];
+}
+
+inline Measurement summarize(const std::vector<double>& values)
+{
+    Measurement m;
+    if (values.empty()) {
+        return m;
+    }
+    m.samples = values.size();
+    m.median = median_of(values);
+    m.mad = mad_of(values, m.median);
+    double total = 0;
+    for (const double value : values) {
+        total += value;
+    }
+    m.mean = total / values.size();
+    median_ci(values, m.ci_low, m.ci_high);
+    return m;
+}
+
+// Runs f(n) repeatedly and returns the summary of the collected samples. Each
+// sample averages enough calls to last at least min_time, and sampling goes on
+// until the confidence interval of the median is narrower than target_ci or
+// the sample or time budget runs out, in which case it is flagged unstable.
+// Calls with an expensive untimed setup (e.g. creating a file) are also cut
+// off by the wall time budget, even before min_samples are collected.
+template <typename Function>
+Measurement measure(Function f, const size_t n, const RunnerConfig& config)
+{
+    using namespace std::chrono;
+    const steady_clock::time_point start = steady_clock::now();
+    auto wall = [start]() { return duration<double, std::milli>(steady_clock::now() - start).count(); };
+
+    // warm-up, then double the batch size until a batch lasts min_time
+    double elapsed = f(n);
+    size_t iterations = 1;
+    for (;;) {
+        double total = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            total += f(n);
+        }
+        elapsed += total;
+        if (total >= config.min_time || elapsed >= config.max_time || wall() >= config.max_wall_time) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    while (samples.size() < config.max_samples) {
+        double total = 0;
+        for (size_t i = 0; i < iterations; ++i) {
+            total += f(n);
+        }
+        elapsed += total;
+        samples.push_back(total / iterations);
+        if (wall() >= config.max_wall_time) {
+            break;
+        }
+
+        if (samples.size() >= config.min_samples) {
+            if (summarize(samples).relative_ci() <= config.target_ci || elapsed >= config.max_time) {
+                break;
+            }
+        }
+    }
+
+    Measurement m = summarize(samples);
+    m.iterations = iterations;
+    m.unstable = m.relative_ci() > config.target_ci || samples.size() < config.min_samples;
+    return m;
+}
+
+#endif // STATS_H
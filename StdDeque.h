@@ -13,16 +13,28 @@
 #include <cstdlib>
 #include <deque>
 
+#include "Operations.h"
+
 template <typename T>
 class StdDeque {
 public:
+    static const char* name() { return "StdDeque"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT |
+                                       OP_POP_FRONT | OP_RANDOM_ACCESS | OP_INSERT;
+
     T& operator[](size_t ind) { return data[ind]; }
+    T& front() { return data.front(); }
+    T& back() { return data.back(); }
 
     void push_back(const T& val) { data.push_back(val); }
     void pop_back() { data.pop_back(); }
     void push_front(const T& val) { data.push_front(val); }
     void pop_front() { data.pop_front(); }
 
+    void insert(size_t pos, const T& val) { data.insert(data.begin() + pos, val); }
+    void erase(size_t pos) { data.erase(data.begin() + pos); }
+    void erase(size_t first, size_t last) { data.erase(data.begin() + first, data.begin() + last); }
+
 private:
     std::deque<T> data;
 };
@@ -11,19 +11,44 @@
 #define STD_LIST_H
 
 #include <cstdlib>
+#include <iterator>
 #include <list>
 
+#include "Operations.h"
+
 template <typename T>
 class StdList {
 public:
-    T& operator[](size_t ind) { return data[ind]; }
+    static const char* name() { return "StdList"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT |
+                                       OP_POP_FRONT | OP_INSERT;
+
+    // linear time, so it is not listed in operations as random access
+    T& operator[](size_t ind) { return *std::next(data.begin(), ind); }
+
+    T& front() { return data.front(); }
+    T& back() { return data.back(); }
 
     void push_back(const T& val) { data.push_back(val); }
     void pop_back() { data.pop_back(); }
     void push_front(const T& val) { data.push_front(val); }
     void pop_front() { data.pop_front(); }
 
+    // positions are found by walking from the nearer end, which is the cost
+    // of inserting and erasing at an index rather than at an iterator
+    void insert(size_t pos, const T& val) { data.insert(at(pos), val); }
+    void erase(size_t pos) { data.erase(at(pos)); }
+    void erase(size_t first, size_t last) { data.erase(at(first), std::next(at(first), last - first)); }
+
 private:
+    typename std::list<T>::iterator at(size_t pos)
+    {
+        if (pos < data.size() - pos) {
+            return std::next(data.begin(), pos);
+        }
+        return std::prev(data.end(), data.size() - pos);
+    }
+
     std::list<T> data;
 };
 
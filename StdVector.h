@@ -13,10 +13,18 @@
 #include <cstdlib>
 #include <vector>
 
+#include "Operations.h"
+
 template <typename T>
 class StdVector {
 public:
+    static const char* name() { return "StdVector"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_RANDOM_ACCESS |
+                                       OP_RESERVE_BACK | OP_LOAD_FACTOR | OP_INSERT;
+
     T& operator[](size_t ind) { return data[ind]; }
+    T& front() { return data.front(); }
+    T& back() { return data.back(); }
 
     float load_factor() { return float(data.size()) / data.capacity(); }
     void reserve_back(size_t n) { data.reserve(n); }
@@ -26,6 +34,10 @@ public:
     void push_front(const T& val) { data.insert(data.begin(), val); }
     void pop_front() { data.erase(data.begin()); }
 
+    void insert(size_t pos, const T& val) { data.insert(data.begin() + pos, val); }
+    void erase(size_t pos) { data.erase(data.begin() + pos); }
+    void erase(size_t first, size_t last) { data.erase(data.begin() + first, data.begin() + last); }
+
 private:
     std::vector<T> data;
 };
@@ -0,0 +1,365 @@
+//
+// TieredVector.h
+//
+// Tiered vector implementation with a ring of circular fixed size tiers
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef TIERED_VECTOR_H
+#define TIERED_VECTOR_H
+
+#include <algorithm>
+#include <iostream>
+
+#include "BufferCache.h"
+#include "Operations.h"
+
+// Elements are stored in tiers of 2^shift elements each, which are circular
+// buffers with their own head, and tiers are kept in a circular array. All
+// tiers are full except the first and the last ones, so an element is found
+// with a shift and two masks. Inserting or erasing in the middle moves the
+// elements of a single tier and rotates the heads of the tiers towards the
+// shorter end, each of which moves a single element between neighbor tiers.
+// The tier size is doubled or halved as the size grows or shrinks, so that
+// both take O(sqrt n) steps.
+template <typename T>
+class TieredVector {
+public:
+    static const char* name() { return "TieredVector"; }
+    static const unsigned operations = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT |
+                                       OP_POP_FRONT | OP_RANDOM_ACCESS |
+                                       OP_LOAD_FACTOR | OP_INSERT;
+
+    TieredVector()
+        : shift(min_shift)
+        , tier_capacity(1)
+        , tier_first(0)
+        , tier_count(0)
+        , size(0)
+        , offset(0)
+        , spare(nullptr)
+    {
+        tiers = new Tier[tier_capacity];
+    }
+
+    ~TieredVector()
+    {
+        for (size_t k = 0; k < tier_count; ++k) {
+            buffer_delete(tier(k).data);
+        }
+        buffer_delete(spare);
+        delete[] tiers;
+    }
+
+    T& operator[](size_t ind) { return at(ind + offset); }
+    T& front() { return at(offset); }
+    T& back() { return at(offset + size - 1); }
+
+    float load_factor()
+    {
+        return static_cast<float>(size) / (std::max<size_t>(tier_count, 1) << shift);
+    }
+
+    void push_back(const T& val)
+    {
+        if (offset + size == tier_count << shift) {
+            add_back();
+        }
+        at(offset + size) = val;
+        size++;
+        if (tier_count > (size_t(2) << shift)) {
+            rebuild(shift + 1);
+        }
+    }
+
+    void pop_back()
+    {
+        size--;
+        if (offset + size <= (tier_count - 1) << shift) {
+            remove_back();
+        }
+        shrink();
+    }
+
+    void push_front(const T& val)
+    {
+        if (offset == 0) {
+            add_front();
+            offset = size_t(1) << shift;
+        }
+        offset--;
+        at(offset) = val;
+        size++;
+        if (tier_count > (size_t(2) << shift)) {
+            rebuild(shift + 1);
+        }
+    }
+
+    void pop_front()
+    {
+        size--;
+        offset++;
+        if (offset == size_t(1) << shift) {
+            remove_front();
+            offset = 0;
+        }
+        shrink();
+    }
+
+    // Inserts before index pos. Elements on the shorter side are moved one
+    // step within the tier of the position, and one element is carried over
+    // between each pair of tiers up to the end.
+    void insert(size_t pos, const T& val)
+    {
+        if (pos < size - pos) {
+            push_front(val);
+            const size_t mask = (size_t(1) << shift) - 1;
+            const size_t p = offset + pos;
+            const size_t first = offset >> shift;
+            const size_t last = p >> shift;
+            for (size_t k = first; k < last; ++k) {
+                tier(k).head++;
+                slot(k, mask) = slot(k + 1, 0);
+            }
+            move_down(last, (std::max(offset, last << shift) & mask) + 1, (p & mask) + 1);
+            at(p) = val;
+        } else {
+            push_back(val);
+            const size_t mask = (size_t(1) << shift) - 1;
+            const size_t p = offset + pos;
+            const size_t end = offset + size - 1;
+            const size_t first = p >> shift;
+            const size_t last = end >> shift;
+            for (size_t k = last; k > first; --k) {
+                tier(k).head--;
+                slot(k, 0) = slot(k - 1, mask);
+            }
+            move_up(first, p & mask, std::min(end, ((first + 1) << shift) - 1) & mask);
+            at(p) = val;
+        }
+    }
+
+    // erases index pos moving the shorter side as in insert
+    void erase(size_t pos)
+    {
+        const size_t mask = (size_t(1) << shift) - 1;
+        const size_t p = offset + pos;
+        if (pos < size - pos - 1) {
+            const size_t first = offset >> shift;
+            const size_t last = p >> shift;
+            move_up(last, std::max(offset, last << shift) & mask, p & mask);
+            for (size_t k = last; k > first; --k) {
+                slot(k, 0) = slot(k - 1, mask);
+                tier(k - 1).head--;
+            }
+            pop_front();
+        } else {
+            const size_t end = offset + size - 1;
+            const size_t first = p >> shift;
+            const size_t last = end >> shift;
+            move_down(first, (p & mask) + 1, (std::min(end, ((first + 1) << shift) - 1) & mask) + 1);
+            for (size_t k = first; k < last; ++k) {
+                slot(k, mask) = slot(k + 1, 0);
+                tier(k + 1).head++;
+            }
+            pop_back();
+        }
+    }
+
+    // Erases indices from first to last - 1, one at a time for short ranges,
+    // or otherwise moving the shorter side over the range at once.
+    void erase(size_t first, size_t last)
+    {
+        const size_t n = last - first;
+        if (n * (size_t(2) << shift) < std::min(first, size - last)) {
+            for (size_t i = 0; i < n; ++i) {
+                erase(first);
+            }
+        } else if (first < size - last) {
+            for (size_t i = first; i > 0; --i) {
+                (*this)[i - 1 + n] = (*this)[i - 1];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                pop_front();
+            }
+        } else {
+            for (size_t i = last; i < size; ++i) {
+                (*this)[i - n] = (*this)[i];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                pop_back();
+            }
+        }
+    }
+
+    void draw()
+    {
+        for (size_t k = 0; k < tier_count; ++k) {
+            std::cout << "|";
+            for (size_t s = 0; s < (size_t(1) << shift); ++s) {
+                size_t p = (k << shift) + s;
+                std::cout << (p >= offset && p < offset + size ? "x|" : " |");
+            }
+            std::cout << ":";
+        }
+        std::cout << std::endl;
+    }
+
+private:
+    static const size_t min_shift = 4;
+
+    struct Tier {
+        T* data;
+        size_t head;
+    };
+
+    // k-th tier from the first one
+    Tier& tier(const size_t k) { return tiers[(tier_first + k) & (tier_capacity - 1)]; }
+
+    T& slot(const size_t k, const size_t s)
+    {
+        Tier& t = tier(k);
+        return t.data[(t.head + s) & ((size_t(1) << shift) - 1)];
+    }
+
+    // positions count from the start of the first tier, i.e. including offset
+    T& at(const size_t p) { return slot(p >> shift, p); }
+
+    // moves slots from first to last - 1 of the k-th tier one slot up
+    void move_up(const size_t k, const size_t first, const size_t last)
+    {
+        const size_t mask = (size_t(1) << shift) - 1;
+        T* data = tier(k).data;
+        const size_t head = tier(k).head;
+        for (size_t s = last; s > first; --s) {
+            data[(head + s) & mask] = data[(head + s - 1) & mask];
+        }
+    }
+
+    // moves slots from first to last - 1 of the k-th tier one slot down
+    void move_down(const size_t k, const size_t first, const size_t last)
+    {
+        const size_t mask = (size_t(1) << shift) - 1;
+        T* data = tier(k).data;
+        const size_t head = tier(k).head;
+        for (size_t s = first; s < last; ++s) {
+            data[(head + s - 1) & mask] = data[(head + s) & mask];
+        }
+    }
+
+    // a single tier is kept when removed so that pushes and pops at the end of
+    // a tier do not allocate each time
+    T* take_tier()
+    {
+        T* data = spare;
+        spare = nullptr;
+        return data != nullptr ? data : buffer_new<T>(size_t(1) << shift);
+    }
+
+    void give_tier(T* data)
+    {
+        if (spare == nullptr) {
+            spare = data;
+        } else {
+            buffer_delete(data);
+        }
+    }
+
+    void grow_tiers()
+    {
+        Tier* new_tiers = new Tier[tier_capacity * 2];
+        for (size_t k = 0; k < tier_count; ++k) {
+            new_tiers[k] = tier(k);
+        }
+        delete[] tiers;
+        tiers = new_tiers;
+        tier_capacity *= 2;
+        tier_first = 0;
+    }
+
+    void add_back()
+    {
+        if (tier_count == tier_capacity) {
+            grow_tiers();
+        }
+        tier_count++;
+        tier(tier_count - 1).data = take_tier();
+        tier(tier_count - 1).head = 0;
+    }
+
+    void add_front()
+    {
+        if (tier_count == tier_capacity) {
+            grow_tiers();
+        }
+        tier_first = (tier_first - 1) & (tier_capacity - 1);
+        tier_count++;
+        tier(0).data = take_tier();
+        tier(0).head = 0;
+    }
+
+    void remove_back()
+    {
+        tier_count--;
+        give_tier(tier(tier_count).data);
+    }
+
+    void remove_front()
+    {
+        give_tier(tier(0).data);
+        tier_first = (tier_first + 1) & (tier_capacity - 1);
+        tier_count--;
+    }
+
+    // halves tiers when they hold less than an eighth of their square
+    void shrink()
+    {
+        if (shift > min_shift && size < (size_t(1) << (2 * shift - 3))) {
+            rebuild(shift - 1);
+        }
+    }
+
+    // copies the elements into tiers of 2^new_shift elements
+    void rebuild(const size_t new_shift)
+    {
+        const size_t block = size_t(1) << new_shift;
+        const size_t new_count = (size + block - 1) / block;
+        size_t new_capacity = 1;
+        while (new_capacity < new_count) {
+            new_capacity *= 2;
+        }
+        Tier* new_tiers = new Tier[new_capacity];
+        for (size_t k = 0; k < new_count; ++k) {
+            new_tiers[k].data = buffer_new<T>(block);
+            new_tiers[k].head = 0;
+            for (size_t i = k * block; i < std::min(size, (k + 1) * block); ++i) {
+                new_tiers[k].data[i - k * block] = (*this)[i];
+            }
+        }
+        for (size_t k = 0; k < tier_count; ++k) {
+            buffer_delete(tier(k).data);
+        }
+        buffer_delete(spare);
+        delete[] tiers;
+        spare = nullptr;
+        tiers = new_tiers;
+        tier_capacity = new_capacity;
+        tier_first = 0;
+        tier_count = new_count;
+        offset = 0;
+        shift = new_shift;
+    }
+
+    Tier* tiers;
+    size_t shift;
+    size_t tier_capacity;
+    size_t tier_first;
+    size_t tier_count;
+    size_t size;
+    size_t offset;
+    T* spare;
+};
+
+#endif // TIERED_VECTOR_H
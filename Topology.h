@@ -0,0 +1,199 @@
+//
+// Topology.h
+//
+// CPU topology from sysfs for placing benchmark workers on separate cores
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// parses kernel cpu lists such as "0-3,8,10-11"
+inline std::vector<int> parse_cpu_list(const std::string& str)
+{
+    std::vector<int> cpus;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") {
+            continue;
+        }
+        size_t dash = item.find('-');
+        int first = std::atoi(item.c_str());
+        int last = dash == std::string::npos ? first : std::atoi(item.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+inline std::string read_sysfs(const std::string& path)
+{
+    std::ifstream in(path);
+    std::string str;
+    std::getline(in, str);
+    return str;
+}
+
+inline std::string cpu_path(const int cpu)
+{
+    return "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+}
+
+// cpus the process is allowed to run on
+inline std::vector<int> allowed_cpus()
+{
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+// lowest numbered cpu sharing the core (i.e. SMT siblings) with the given one
+inline int core_leader(const int cpu)
+{
+    std::vector<int> siblings = parse_cpu_list(read_sysfs(cpu_path(cpu) + "/topology/thread_siblings_list"));
+    return siblings.empty() ? cpu : *std::min_element(siblings.begin(), siblings.end());
+}
+
+// lowest numbered cpu sharing the last level cache with the given one
+inline int llc_leader(const int cpu)
+{
+    int leader = cpu;
+    int level = 0;
+    for (int index = 0;; ++index) {
+        std::string path = cpu_path(cpu) + "/cache/index" + std::to_string(index);
+        std::string lvl = read_sysfs(path + "/level");
+        if (lvl.empty()) {
+            break;
+        }
+        std::vector<int> shared = parse_cpu_list(read_sysfs(path + "/shared_cpu_list"));
+        if (std::atoi(lvl.c_str()) >= level && !shared.empty()) {
+            level = std::atoi(lvl.c_str());
+            leader = *std::min_element(shared.begin(), shared.end());
+        }
+    }
+    return leader;
+}
+
+// Picks cpus for up to jobs workers (all usable ones if jobs is 0). Cpus listed
+// in /sys/devices/system/cpu/isolated are preferred when the process may run on
+// any of them. Only one SMT sibling of each core is used, and with one_per_llc
+// only one core of each last level cache domain so that workers do not evict
+// each other.
+inline std::vector<int> select_worker_cpus(const size_t jobs, const bool one_per_llc)
+{
+    std::vector<int> allowed = allowed_cpus();
+    std::vector<int> candidates;
+    for (const int cpu : parse_cpu_list(read_sysfs("/sys/devices/system/cpu/isolated"))) {
+        if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+            candidates.push_back(cpu);
+        }
+    }
+    if (candidates.empty()) {
+        candidates = allowed;
+    }
+
+    std::vector<int> cpus;
+    std::set<int> cores;
+    std::set<int> llcs;
+    for (const int cpu : candidates) {
+        if (!cores.insert(core_leader(cpu)).second) {
+            continue;
+        }
+        if (one_per_llc && !llcs.insert(llc_leader(cpu)).second) {
+            continue;
+        }
+        cpus.push_back(cpu);
+        if (jobs > 0 && cpus.size() == jobs) {
+            break;
+        }
+    }
+    return cpus;
+}
+
+// returns true if any two of the given cpus share a last level cache
+inline bool share_llc(const std::vector<int>& cpus)
+{
+    std::set<int> llcs;
+    for (const int cpu : cpus) {
+        if (!llcs.insert(llc_leader(cpu)).second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct CacheLevel {
+    int level;
+    size_t size; // bytes
+};
+
+// parses sysfs cache sizes such as "48K" or "2M"
+inline size_t parse_cache_size(const std::string& str)
+{
+    char* end;
+    size_t size = std::strtoul(str.c_str(), &end, 10);
+    if (*end == 'K') {
+        size *= 1024;
+    } else if (*end == 'M') {
+        size *= 1024 * 1024;
+    } else if (*end == 'G') {
+        size *= 1024 * 1024 * 1024;
+    }
+    return size;
+}
+
+// data and unified caches of the given cpu ordered by level, instruction
+// caches are skipped as the benchmarks only stream data
+inline std::vector<CacheLevel> read_caches(const int cpu)
+{
+    std::vector<CacheLevel> caches;
+    for (int index = 0;; ++index) {
+        std::string path = cpu_path(cpu) + "/cache/index" + std::to_string(index);
+        std::string level = read_sysfs(path + "/level");
+        if (level.empty()) {
+            break;
+        }
+        if (read_sysfs(path + "/type") == "Instruction") {
+            continue;
+        }
+        CacheLevel cache = { std::atoi(level.c_str()), parse_cache_size(read_sysfs(path + "/size")) };
+        if (cache.size > 0) {
+            caches.push_back(cache);
+        }
+    }
+    std::sort(caches.begin(), caches.end(),
+              [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return caches;
+}
+
+inline bool pin_to_cpu(const int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+#endif // TOPOLOGY_H
@@ -0,0 +1,268 @@
+//
+// Trace.h
+//
+// Compact binary traces of container operations for recording and replay
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Operations.h"
+
+// A trace is a header followed by one 32 bit little endian record per
+// operation. The top 3 bits of a record hold the opcode and the low 29 bits
+// the operand, which is the index relative to the front for TRACE_INDEX and
+// unused (i.e. zero) otherwise.
+enum TraceOpcode {
+    TRACE_PUSH_BACK,
+    TRACE_POP_BACK,
+    TRACE_PUSH_FRONT,
+    TRACE_POP_FRONT,
+    TRACE_INDEX,
+};
+
+static const uint32_t TRACE_OPERAND_BITS = 29;
+static const uint32_t TRACE_OPERAND_MASK = (1u << TRACE_OPERAND_BITS) - 1;
+static const char TRACE_MAGIC[8] = { 'S', 'T', 'L', 'T', 'R', 'A', 'C', 'E' };
+static const uint32_t TRACE_VERSION = 1;
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t count; // number of records
+};
+
+inline uint32_t trace_record(const TraceOpcode op, const size_t operand)
+{
+    return static_cast<uint32_t>(op) << TRACE_OPERAND_BITS |
+           (static_cast<uint32_t>(operand) & TRACE_OPERAND_MASK);
+}
+
+inline TraceOpcode trace_opcode(const uint32_t record)
+{
+    return static_cast<TraceOpcode>(record >> TRACE_OPERAND_BITS);
+}
+
+inline size_t trace_operand(const uint32_t record)
+{
+    return record & TRACE_OPERAND_MASK;
+}
+
+inline unsigned trace_operation(const TraceOpcode op)
+{
+    switch (op) {
+    case TRACE_PUSH_BACK:
+        return OP_PUSH_BACK;
+    case TRACE_POP_BACK:
+        return OP_POP_BACK;
+    case TRACE_PUSH_FRONT:
+        return OP_PUSH_FRONT;
+    case TRACE_POP_FRONT:
+        return OP_POP_FRONT;
+    default:
+        return OP_RANDOM_ACCESS;
+    }
+}
+
+// Read only view of a trace file mapped into memory, records are used in place
+// without copying. The mapping is shared with forked workers.
+class TraceFile {
+public:
+    TraceFile()
+        : records(nullptr)
+        , count(0)
+        , ops(0)
+        , map(nullptr)
+        , map_size(0)
+    {
+    }
+
+    ~TraceFile()
+    {
+        if (map) {
+            munmap(map, map_size);
+        }
+    }
+
+    // returns false and prints a message if the file is not a valid trace
+    bool open(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "cannot open trace file '" << path << "'" << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TraceHeader)) {
+            std::cerr << "trace file '" << path << "' is too short" << std::endl;
+            close(fd);
+            return false;
+        }
+        map_size = static_cast<size_t>(st.st_size);
+        map = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            map = nullptr;
+            std::cerr << "cannot map trace file '" << path << "'" << std::endl;
+            return false;
+        }
+
+        const TraceHeader* header = static_cast<const TraceHeader*>(map);
+        if (std::memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+            header->version != TRACE_VERSION) {
+            std::cerr << "trace file '" << path << "' has an unknown format" << std::endl;
+            return false;
+        }
+        if (header->count > (map_size - sizeof(TraceHeader)) / sizeof(uint32_t)) {
+            std::cerr << "trace file '" << path << "' is truncated" << std::endl;
+            return false;
+        }
+        const uint32_t* first = reinterpret_cast<const uint32_t*>(header + 1);
+        const size_t n = static_cast<size_t>(header->count);
+        madvise(map, map_size, MADV_SEQUENTIAL);
+
+        // opcodes past TRACE_INDEX are not defined by this version
+        unsigned found = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (trace_opcode(first[i]) > TRACE_INDEX) {
+                std::cerr << "trace file '" << path << "' has an unknown format" << std::endl;
+                return false;
+            }
+            found |= trace_operation(trace_opcode(first[i]));
+        }
+        records = first;
+        count = n;
+        ops = found;
+        return true;
+    }
+
+    const uint32_t* begin() const { return records; }
+    const uint32_t* end() const { return records + count; }
+    size_t size() const { return count; }
+
+    // Operation flags needed to replay the trace
+    unsigned operations() const { return ops; }
+
+private:
+    TraceFile(const TraceFile&);
+    TraceFile& operator=(const TraceFile&);
+
+    const uint32_t* records;
+    size_t count;
+    unsigned ops;
+    void* map;
+    size_t map_size;
+};
+
+// Buffered trace writer. The record count in the header is updated after the
+// records of each flush are written, so that the file holds a valid trace of
+// the flushed records if the process dies before close. Writing stops at the
+// first failed write, after which write and close return false.
+class TraceWriter {
+public:
+    TraceWriter()
+        : file(nullptr)
+        , count(0)
+        , failed(false)
+    {
+    }
+
+    ~TraceWriter() { close(); }
+
+    bool open(const std::string& path)
+    {
+        close();
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        count = 0;
+        failed = false;
+        buffer.reserve(buffer_size);
+        TraceHeader header = header_for(0);
+        failed = std::fwrite(&header, sizeof(header), 1, file) != 1;
+        return !failed;
+    }
+
+    bool write(const TraceOpcode op, const size_t operand)
+    {
+        if (failed) {
+            return false;
+        }
+        buffer.push_back(trace_record(op, operand));
+        if (buffer.size() == buffer_size) {
+            return flush();
+        }
+        return true;
+    }
+
+    bool close()
+    {
+        if (!file) {
+            return false;
+        }
+        bool ok = flush();
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    TraceWriter(const TraceWriter&);
+    TraceWriter& operator=(const TraceWriter&);
+
+    static const size_t buffer_size = 4096;
+
+    static TraceHeader header_for(const uint64_t count)
+    {
+        TraceHeader header;
+        std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        header.version = TRACE_VERSION;
+        header.reserved = 0;
+        header.count = count;
+        return header;
+    }
+
+    // writes the buffered records and then the new count, seeking flushes the
+    // records to the file before the count
+    bool flush()
+    {
+        if (failed || buffer.empty()) {
+            buffer.clear();
+            return !failed;
+        }
+        TraceHeader header = header_for(count + buffer.size());
+        failed = std::fwrite(buffer.data(), sizeof(uint32_t), buffer.size(), file) != buffer.size() ||
+                 std::fseek(file, 0, SEEK_SET) != 0 ||
+                 std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+                 std::fseek(file, 0, SEEK_END) != 0;
+        if (!failed) {
+            count += buffer.size();
+        }
+        buffer.clear();
+        return !failed;
+    }
+
+    std::FILE* file;
+    uint64_t count;
+    bool failed;
+    std::vector<uint32_t> buffer;
+};
+
+#endif // TRACE_H
@@ -0,0 +1,96 @@
+//
+// TraceRecorder.h
+//
+// Drop in wrapper recording the operations on a container as a trace
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <string>
+#include <utility>
+
+#include "Trace.h"
+
+// Wraps a container with the push/pop interface of std::deque and writes each
+// push, pop and indexed access to a trace file, e.g.
+//
+//     TraceRecorder<std::deque<Request>> requests("requests.trace");
+//
+// Other member functions are reachable through container(), but are not
+// recorded. A recorder is not thread safe, use one per thread if needed.
+template <typename Container>
+class TraceRecorder {
+public:
+    explicit TraceRecorder(const std::string& path) { recording = writer.open(path); }
+
+    // false if the trace file could not be created or written, operations
+    // still work
+    bool is_recording() const { return recording; }
+
+    template <typename V>
+    void push_back(V&& val)
+    {
+        record(TRACE_PUSH_BACK, 0);
+        data.push_back(std::forward<V>(val));
+    }
+
+    void pop_back()
+    {
+        record(TRACE_POP_BACK, 0);
+        data.pop_back();
+    }
+
+    template <typename V>
+    void push_front(V&& val)
+    {
+        record(TRACE_PUSH_FRONT, 0);
+        data.push_front(std::forward<V>(val));
+    }
+
+    void pop_front()
+    {
+        record(TRACE_POP_FRONT, 0);
+        data.pop_front();
+    }
+
+    auto operator[](size_t ind) -> decltype(std::declval<Container&>()[ind])
+    {
+        record(TRACE_INDEX, ind);
+        return data[ind];
+    }
+
+    auto front() -> decltype(std::declval<Container&>().front())
+    {
+        record(TRACE_INDEX, 0);
+        return data.front();
+    }
+
+    auto back() -> decltype(std::declval<Container&>().back())
+    {
+        record(TRACE_INDEX, data.size() - 1);
+        return data.back();
+    }
+
+    size_t size() const { return data.size(); }
+    bool empty() const { return data.empty(); }
+
+    Container& container() { return data; }
+
+private:
+    void record(const TraceOpcode op, const size_t operand)
+    {
+        if (recording) {
+            recording = writer.write(op, operand);
+        }
+    }
+
+    Container data;
+    TraceWriter writer;
+    bool recording;
+};
+
+#endif // TRACE_RECORDER_H
@@ -0,0 +1,211 @@
+//
+// Workload.h
+//
+// Synthetic workloads generated from operation mixes as traces
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Operations.h"
+#include "Trace.h"
+
+// Operation weights are relative to each other. With a depth target, pushes
+// and pops are chosen to keep the size at the target, which oscillates with
+// the given relative amplitude over period operations when period is set.
+// Bursts alternate between on operations that only push and off operations
+// that only pop, ignoring the depth target.
+struct WorkloadSpec {
+    WorkloadSpec()
+        : push_back(0.5)
+        , push_front(0)
+        , pop_back(0)
+        , pop_front(0.5)
+        , index(0)
+        , depth(0)
+        , amplitude(0)
+        , period(0)
+        , burst_on(0)
+        , burst_off(0)
+        , seed(1)
+    {
+    }
+
+    std::string name;
+    double push_back;
+    double push_front;
+    double pop_back;
+    double pop_front;
+    double index;
+    size_t depth;
+    double amplitude;
+    size_t period;
+    size_t burst_on;
+    size_t burst_off;
+    unsigned seed;
+
+    bool operator==(const WorkloadSpec& that) const
+    {
+        return name == that.name && push_back == that.push_back && push_front == that.push_front &&
+               pop_back == that.pop_back && pop_front == that.pop_front && index == that.index &&
+               depth == that.depth && amplitude == that.amplitude && period == that.period &&
+               burst_on == that.burst_on && burst_off == that.burst_off && seed == that.seed;
+    }
+
+    bool operator!=(const WorkloadSpec& that) const { return !(*this == that); }
+};
+
+// Parses specs such as "name=bursty,push_back=1,pop_front=1,on=100,off=100",
+// returns false with a message in error on invalid specs.
+inline bool parse_workload(const std::string& str, WorkloadSpec& spec, std::string& error)
+{
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            error = "missing value for '" + item + "'";
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string val = item.substr(eq + 1);
+        char* end;
+        double num = std::strtod(val.c_str(), &end);
+        bool is_num = !val.empty() && *end == '\0' && num >= 0;
+
+        if (key == "name") {
+            spec.name = val;
+            continue;
+        }
+        if (!is_num) {
+            error = "invalid value for '" + key + "'";
+            return false;
+        }
+        if (key == "push_back") {
+            spec.push_back = num;
+        } else if (key == "push_front") {
+            spec.push_front = num;
+        } else if (key == "pop_back") {
+            spec.pop_back = num;
+        } else if (key == "pop_front") {
+            spec.pop_front = num;
+        } else if (key == "index") {
+            spec.index = num;
+        } else if (key == "depth") {
+            spec.depth = static_cast<size_t>(num);
+        } else if (key == "amplitude") {
+            spec.amplitude = num;
+        } else if (key == "period") {
+            spec.period = static_cast<size_t>(num);
+        } else if (key == "on") {
+            spec.burst_on = static_cast<size_t>(num);
+        } else if (key == "off") {
+            spec.burst_off = static_cast<size_t>(num);
+        } else if (key == "seed") {
+            spec.seed = static_cast<unsigned>(num);
+        } else {
+            error = "unknown key '" + key + "'";
+            return false;
+        }
+    }
+
+    if (spec.push_back + spec.push_front <= 0) {
+        error = "push_back or push_front weight is needed";
+        return false;
+    }
+    if (spec.amplitude > 1) {
+        error = "amplitude is larger than 1";
+        return false;
+    }
+    if (spec.burst_off > 0 && spec.burst_on == 0) {
+        error = "off is given without on";
+        return false;
+    }
+    return true;
+}
+
+// Operation flags needed to replay the workload
+inline unsigned workload_operations(const WorkloadSpec& spec)
+{
+    return (spec.push_back > 0 ? OP_PUSH_BACK : 0) | (spec.push_front > 0 ? OP_PUSH_FRONT : 0) |
+           (spec.pop_back > 0 ? OP_POP_BACK : 0) | (spec.pop_front > 0 ? OP_POP_FRONT : 0) |
+           (spec.index > 0 ? OP_RANDOM_ACCESS : 0);
+}
+
+// Generates ops trace records after the pushes that fill the container up to
+// its initial depth, and returns the number of these warm up records. Pops
+// are turned into pushes when the container is empty so that replays do not
+// skip any operations.
+inline size_t generate_workload(const WorkloadSpec& spec, const size_t ops, std::vector<uint32_t>& records)
+{
+    enum { PUSH, POP, INDEX };
+
+    std::mt19937 gen(spec.seed);
+    std::uniform_real_distribution<double> unit(0, 1);
+    const double pushes = spec.push_back + spec.push_front;
+    const double pops = spec.pop_back + spec.pop_front;
+    const double total = pushes + pops + spec.index;
+    const double pi = std::acos(-1.0);
+    size_t size = 0;
+
+    records.clear();
+    records.reserve(spec.depth + ops);
+
+    for (size_t i = 0; i < spec.depth; ++i) {
+        bool back = unit(gen) * pushes < spec.push_back;
+        records.push_back(trace_record(back ? TRACE_PUSH_BACK : TRACE_PUSH_FRONT, 0));
+        size++;
+    }
+    const size_t warmup = records.size();
+
+    for (size_t i = 0; i < ops; ++i) {
+        int kind;
+        if (spec.burst_on > 0) {
+            kind = i % (spec.burst_on + spec.burst_off) < spec.burst_on ? PUSH : POP;
+        } else {
+            double r = unit(gen) * total;
+            kind = r < pushes ? PUSH : (r < pushes + pops ? POP : INDEX);
+            if (spec.depth > 0 && kind != INDEX) {
+                double target = static_cast<double>(spec.depth);
+                if (spec.period > 0) {
+                    target *= 1 + spec.amplitude * std::sin(2 * pi * i / spec.period);
+                }
+                if (size < target) {
+                    kind = PUSH;
+                } else if (size > target) {
+                    kind = POP;
+                }
+            }
+        }
+        if (kind == POP && (size == 0 || pops <= 0)) {
+            kind = PUSH;
+        }
+
+        if (kind == PUSH) {
+            bool back = unit(gen) * pushes < spec.push_back;
+            records.push_back(trace_record(back ? TRACE_PUSH_BACK : TRACE_PUSH_FRONT, 0));
+            size++;
+        } else if (kind == POP) {
+            bool back = unit(gen) * pops < spec.pop_back;
+            records.push_back(trace_record(back ? TRACE_POP_BACK : TRACE_POP_FRONT, 0));
+            size--;
+        } else {
+            size_t ind = size > 0 ? static_cast<size_t>(unit(gen) * size) : 0;
+            records.push_back(trace_record(TRACE_INDEX, ind < size ? ind : 0));
+        }
+    }
+
+    return warmup;
+}
+
+#endif // WORKLOAD_H
@@ -8,73 +8,280 @@
 //
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <numeric>
 #include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 #include <json/json.h>
 
+#include "Blob.h"
+#include "BufferCache.h"
+#include "Counted.h"
+#include "DaryHeap.h"
 #include "DequeConservative.h"
 #include "DequeNaive.h"
 #include "DequeReclaiming.h"
+#include "Graph.h"
+#include "HeapStats.h"
+#include "IndexIterator.h"
+#include "MappedQueue.h"
+#include "Options.h"
 #include "QueueConservative.h"
 #include "QueueNaive.h"
 #include "QueueReclaiming.h"
+#include "Registry.h"
+#include "Results.h"
+#include "Scheduler.h"
+#include "Stats.h"
 #include "StdDeque.h"
 #include "StdList.h"
 #include "StdVector.h"
+#include "TieredVector.h"
+#include "Topology.h"
+#include "Trace.h"
+#include "Workload.h"
 
 struct Small {
+    static const char* name() { return "Small"; }
+    static const size_t scale = 100;
+
     int data[1];
-    bool operator<(const Small& that)
+    bool operator<(const Small& that) const
     {
         return this->data[0] < that.data[0];
     }
 };
 
 struct Medium {
+    static const char* name() { return "Medium"; }
+    static const size_t scale = 100;
+
     int data[10];
-    bool operator<(const Medium& that)
+    bool operator<(const Medium& that) const
     {
         return this->data[0] < that.data[0];
     }
 };
 
 struct Large {
+    static const char* name() { return "Large"; }
+    static const size_t scale = 10;
+
     int data[100];
-    bool operator<(const Large& that)
+    bool operator<(const Large& that) const
     {
         return this->data[0] < that.data[0];
     }
 };
 
-template <typename> static Json::Value fill_back_test(const size_t);
-template <typename> static Json::Value fill_back_reserved_test(const size_t);
-template <typename> static Json::Value fill_front_test(const size_t);
-template <typename> static Json::Value fill_front_reserved_test(const size_t);
-template <typename> static Json::Value queue_test(const size_t);
-template <typename> static Json::Value zigzag_test(const size_t);
-template <typename> static Json::Value traverse_test(const size_t);
-template <typename> static Json::Value shuffle_test(const size_t);
-template <typename> static Json::Value qsort_test(const size_t);
+typedef TypeList<Small, Medium, Large, Counted, CountedHeap> ElementTypes;
+
+// element sizes of the blob tests which are run at a fixed byte footprint
+typedef TypeList<Blob<8>, Blob<16>, Blob<32>, Blob<64>, Blob<128>, Blob<256>, Blob<1024>, Blob<4096>> BlobTypes;
+
+// element types of the heap tests, i.e. integer keys and keys with large payloads
+typedef TypeList<Small, Large> HeapTypes;
+
+// element types that are written to files as they are in recovery tests
+typedef TypeList<Small, Medium, Large> PlainTypes;
+
+typedef ContainerList<StdVector,
+                      StdDeque,
+                      StdList,
+                      QueueNaive,
+                      QueueReclaiming,
+                      QueueConservative,
+                      DequeNaive,
+                      DequeReclaiming,
+                      DequeConservative,
+                      TieredVector,
+                      MappedQueue> Containers;
+
+// a chart of a test with one column per container and one row per size
+struct Chart {
+    std::string name;
+    bool memory;
+    std::string metric; // metric of memory charts, e.g. "load"
+    std::string axis;   // title of the horizontal axis
+    Json::Value data;
+};
+
+// a single measurement of a test for one container, element type and size
+struct Cell {
+    Result r;
+    std::function<double(size_t)> run;
+    std::function<void()> release; // frees data shared by the calls of run
+    bool counted;
+    size_t chart;
+    Json::ArrayIndex row;
+    int col;
+};
+
+static Options options;
+static std::vector<Chart> charts;
+static std::vector<Cell> cells;
+static std::vector<Result> results;
+static size_t unstable_count = 0;
+static std::vector<CacheLevel> caches;
+static std::deque<TraceFile> traces;
+static std::vector<WorkloadSpec> workloads;
+
+static std::string format_bytes(const size_t bytes)
+{
+    static const char* units[] = { "B", "K", "M", "G" };
+    double size = static_cast<double>(bytes);
+    int unit = 0;
+    while (size >= 1024 && unit < 3) {
+        size /= 1024;
+        unit++;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.4g%s", size, units[unit]);
+    return buf;
+}
+
+// Geometric sizes with footprints doubling from a quarter of the first cache
+// level up to twice the last one, along with footprints at and just around
+// each cache size so that every boundary is crossed between adjacent sizes.
+static std::vector<size_t> get_cache_sizes(const size_t elem_size)
+{
+    std::vector<size_t> bytes;
+    for (size_t b = caches.front().size / 4; b <= caches.back().size * 2; b *= 2) {
+        bytes.push_back(b);
+    }
+    for (const auto& cache : caches) {
+        bytes.push_back(cache.size * 4 / 5);
+        bytes.push_back(cache.size);
+        bytes.push_back(cache.size * 5 / 4);
+    }
+
+    std::vector<size_t> sizes;
+    for (const size_t b : bytes) {
+        sizes.push_back(b / elem_size > 0 ? b / elem_size : 1);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+// Cache sweeps do not scale with the step, so sizes above max_elements are
+// dropped for tests that would not finish at the largest footprints.
+static std::vector<size_t> get_sizes(const size_t step, const size_t elem_size, const size_t max_elements = 0)
+{
+    if (!options.sizes.empty()) {
+        return options.sizes;
+    }
+    if (options.sweep == "cache") {
+        std::vector<size_t> sizes = get_cache_sizes(elem_size);
+        if (max_elements > 0) {
+            sizes.erase(std::upper_bound(sizes.begin(), sizes.end(), max_elements), sizes.end());
+            if (sizes.empty()) {
+                sizes.push_back(max_elements);
+            }
+        }
+        return sizes;
+    }
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < options.steps; ++i) {
+        sizes.push_back((i + 1) * step);
+    }
+    return sizes;
+}
+
+// names the caches whose size lies in (prev, bytes] for marking boundaries
+static std::string cache_boundaries(const size_t prev, const size_t bytes)
+{
+    std::string label;
+    for (const auto& cache : caches) {
+        if (prev < cache.size && cache.size <= bytes) {
+            label += (label.empty() ? "L" : " L") + std::to_string(cache.level);
+        }
+    }
+    return label;
+}
+
+// cache sweeps have an annotation column after the domain column which google
+// charts draws as vertical lines at the cache boundaries
+static int domain_columns()
+{
+    return options.sweep == "cache" ? 2 : 1;
+}
+
+static const char* domain_title()
+{
+    return options.sweep == "cache" ? "n * element size" : "n";
+}
+
+static bool selected(const std::string& test, const std::string& type)
+{
+    return (matches(options.tests, test) || matches(options.tests, test + type)) &&
+           matches(options.types, type);
+}
+
+static bool selected_column(const Json::Value& res, const int col)
+{
+    return matches(options.containers, res["cols"][col]["label"].asString()) ||
+           matches(options.containers, res["cols"][col]["id"].asString());
+}
+
+// drops the columns of containers that are filtered out on the command line
+static Json::Value select_columns(const Json::Value& res)
+{
+    std::vector<int> cols;
+    for (int col = 0; col < static_cast<int>(res["cols"].size()); ++col) {
+        if (col < domain_columns() || selected_column(res, col)) {
+            cols.push_back(col);
+        }
+    }
+
+    Json::Value sel;
+    for (Json::ArrayIndex j = 0; j < cols.size(); ++j) {
+        sel["cols"][j] = res["cols"][cols[j]];
+    }
+    for (Json::ArrayIndex i = 0; i < res["rows"].size(); ++i) {
+        for (Json::ArrayIndex j = 0; j < cols.size(); ++j) {
+            sel["rows"][i]["c"][j] = res["rows"][i]["c"].get(cols[j], Json::Value());
+        }
+    }
+    return sel;
+}
 
-template <typename> static Json::Value fill_back_memory_test(const size_t);
-template <typename> static Json::Value fill_front_memory_test(const size_t);
-template <typename> static Json::Value queue_memory_test(const size_t);
-template <typename> static Json::Value zigzag_memory_test(const size_t);
+// single line json without stripping the spaces inside formatted values
+static std::string compact_json(const Json::Value& value)
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, value);
+}
 
 static void print_test_data(std::ofstream& out,
                             std::vector<std::string>& test_names,
                             const std::string& test_name,
+                            const std::string& axis,
                             const Json::Value& test_data)
 {
     test_names.push_back(test_name);
-    std::string str = test_data.toStyledString();
-    str.erase(remove_if(str.begin(), str.end(), ::isspace), str.end());
+    std::string str = compact_json(select_columns(test_data));
     out << "var json" << test_name << " = " << str << ";" << std::endl;
     out << "var data" << test_name << " = new google.visualization.DataTable(json"
         << test_name << ");" << std::endl;
@@ -84,21 +291,39 @@ static void print_test_data(std::ofstream& out,
     out << "chart" << test_name << ".draw(data" << test_name << ", {"
         << "title: '" << test_name << "', "
         << "backgroundColor: {fill:'transparent'}, "
-        << "vAxis: {title: 'time (ms)'}, "
-        << "hAxis: {title: 'n'}, "
+        << "vAxis: {title: '" << (options.per_op ? "time per op (ns)" : "time (ms)") << "'}, "
+        << "hAxis: {title: '" << axis << "'}, "
+        << "annotations: {style: 'line'}, "
         << "width: 'auto', "
         << "height: 500});" << std::endl;
     out << std::endl;
 }
 
+// vertical axis titles of memory metrics, which are fractions except for
+// sizes in MB
+static const char* metric_title(const std::string& metric)
+{
+    if (metric == "rss") {
+        return "rss growth (MB)";
+    }
+    if (metric == "heap") {
+        return "peak heap (MB)";
+    }
+    if (metric == "fragmentation") {
+        return "free fraction of heap";
+    }
+    return "load";
+}
+
 static void print_memory_test_data(std::ofstream& out,
                                    std::vector<std::string>& test_names,
                                    const std::string& test_name,
+                                   const std::string& axis,
+                                   const std::string& metric,
                                    const Json::Value& test_data)
 {
     test_names.push_back(test_name);
-    std::string str = test_data.toStyledString();
-    str.erase(remove_if(str.begin(), str.end(), ::isspace), str.end());
+    std::string str = compact_json(select_columns(test_data));
     out << "var json" << test_name << " = " << str << ";" << std::endl;
     out << "var data" << test_name << " = new google.visualization.DataTable(json"
         << test_name << ");" << std::endl;
@@ -108,85 +333,35 @@ static void print_memory_test_data(std::ofstream& out,
     out << "chart" << test_name << ".draw(data" << test_name << ", {"
         << "title: '" << test_name << "', "
         << "backgroundColor: {fill:'transparent'}, "
-        << "vAxis: {title: 'load', minValue: 0, maxValue: 1}, "
-        << "hAxis: {title: 'n'}, "
+        << "vAxis: {title: '" << metric_title(metric) << "', minValue: 0"
+        << (metric == "rss" || metric == "heap" ? "" : ", maxValue: 1") << "}, "
+        << "hAxis: {title: '" << axis << "'}, "
+        << "annotations: {style: 'line'}, "
         << "width: 'auto', "
         << "height: 500});" << std::endl;
     out << std::endl;
 }
 
-static void run_tests_and_print_html(std::ofstream& out)
-{
-    out << " <html>" << std::endl;
-    out << "   <head>" << std::endl;
-    out << "     <!--Load the AJAX API-->" << std::endl;
-    out << "     <script type='text/javascript' "
-           "src='https://www.google.com/jsapi'></script>" << std::endl;
-    out << "     <script type='text/javascript' "
-           "src='//ajax.googleapis.com/ajax/libs/jquery/1.10.2/jquery.min.js'></"
-           "script>" << std::endl;
-    out << "     <script type='text/javascript'>" << std::endl;
-    out << std::endl;
-    out << "     google.load('visualization', '1', {'packages':['corechart']});"
-        << std::endl;
-    out << std::endl;
-    out << "     google.setOnLoadCallback(drawChart);" << std::endl;
-    out << std::endl;
-    out << "     function drawChart() {" << std::endl;
-
-    // run tests and print data
-    size_t n = 1000;
-    std::vector<std::string> test_names;
-    print_test_data(out, test_names, "FillBackSmall"          , fill_back_test<Small>(100 * n));
-    print_test_data(out, test_names, "FillBackMedium"         , fill_back_test<Medium>(100 * n));
-    print_test_data(out, test_names, "FillBackLarge"          , fill_back_test<Large>(10 * n));
-    print_test_data(out, test_names, "FillBackReservedSmall"  , fill_back_reserved_test<Small>(100 * n));
-    print_test_data(out, test_names, "FillBackReservedMedium" , fill_back_reserved_test<Medium>(100 * n));
-    print_test_data(out, test_names, "FillBackReservedLarge"  , fill_back_reserved_test<Large>(10 * n));
-    print_test_data(out, test_names, "FillFrontSmall"         , fill_front_test<Small>(100 * n));
-    print_test_data(out, test_names, "FillFrontMedium"        , fill_front_test<Medium>(100 * n));
-    print_test_data(out, test_names, "FillFrontLarge"         , fill_front_test<Large>(10 * n));
-    print_test_data(out, test_names, "FillFrontReservedSmall" , fill_front_reserved_test<Small>(100 * n));
-    print_test_data(out, test_names, "FillFrontReservedMedium", fill_front_reserved_test<Medium>(100 * n));
-    print_test_data(out, test_names, "FillFrontReservedLarge" , fill_front_reserved_test<Large>(10 * n));
-    print_test_data(out, test_names, "QueueSmall"             , queue_test<Small>(100 * n));
-    print_test_data(out, test_names, "QueueMedium"            , queue_test<Medium>(100 * n));
-    print_test_data(out, test_names, "QueueLarge"             , queue_test<Large>(10 * n));
-    print_test_data(out, test_names, "ZigzagSmall"            , zigzag_test<Small>(100 * n));
-    print_test_data(out, test_names, "ZigzagMedium"           , zigzag_test<Medium>(100 * n));
-    print_test_data(out, test_names, "ZigzagLarge"            , zigzag_test<Large>(10 * n));
-    print_test_data(out, test_names, "TraverseSmall"          , traverse_test<Small>(100 * n));
-    print_test_data(out, test_names, "TraverseMedium"         , traverse_test<Medium>(100 * n));
-    print_test_data(out, test_names, "TraverseLarge"          , traverse_test<Large>(10 * n));
-    print_test_data(out, test_names, "ShuffleSmall"           , shuffle_test<Small>(100 * n));
-    print_test_data(out, test_names, "ShuffleMedium"          , shuffle_test<Medium>(100 * n));
-    print_test_data(out, test_names, "ShuffleLarge"           , shuffle_test<Large>(10 * n));
-    print_test_data(out, test_names, "QSortSmall"             , qsort_test<Small>(10 * n));
-    print_test_data(out, test_names, "QSortMedium"            , qsort_test<Medium>(10 * n));
-    print_test_data(out, test_names, "QSortLarge"             , qsort_test<Large>(10 * n));
-
-    print_memory_test_data(out, test_names, "FillBackMemory"  , fill_back_memory_test<Small>(100 * n));
-    print_memory_test_data(out, test_names, "FillFrontMemory" , fill_front_memory_test<Small>(100 * n));
-    print_memory_test_data(out, test_names, "QueueMemory"     , queue_memory_test<Small>(100 * n));
-    print_memory_test_data(out, test_names, "ZigzagMemory"    , zigzag_memory_test<Small>(100 * n));
-
-    out << "    }" << std::endl;
-    out << std::endl;
-    out << "    </script>" << std::endl;
-    out << "  </head>" << std::endl;
-    out << std::endl;
-    out << "  <body>" << std::endl;
+template <typename K>
+struct ColumnBuilder {
+    Json::Value& res;
+    int col;
 
-    // print divs for graphs
-    for (const auto test_name : test_names) {
-        out << "<div id='div" << test_name << "'></div>" << std::endl;
+    template <template <typename> class Container>
+    void operator()(ContainerTag<Container>)
+    {
+        std::string label = Container<char>::name();
+        if (std::is_same<typename Resolve<K, Container>::type, NotRun>::value) {
+            label = "(NR)" + label;
+        }
+        col++;
+        res["cols"][col]["id"] = to_lower(Container<char>::name());
+        res["cols"][col]["label"] = label;
+        res["cols"][col]["type"] = "number";
     }
+};
 
-    out << "  </body>" << std::endl;
-    out << "</html>" << std::endl;
-}
-
-static Json::Value get_json_template()
+static Json::Value get_domain_template()
 {
     Json::Value res;
 
@@ -194,56 +369,199 @@ static Json::Value get_json_template()
     res["cols"][0]["label"] = "N";
     res["cols"][0]["type"] = "string";
 
-    res["cols"][1]["id"] = "stdvector";
-    res["cols"][1]["label"] = "StdVector";
-    res["cols"][1]["type"] = "number";
+    if (options.sweep == "cache") {
+        res["cols"][1]["type"] = "string";
+        res["cols"][1]["role"] = "annotation";
+    }
 
-    res["cols"][2]["id"] = "stddeque";
-    res["cols"][2]["label"] = "StdDeque";
-    res["cols"][2]["type"] = "number";
+    return res;
+}
 
-    res["cols"][3]["id"] = "stdlist";
-    res["cols"][3]["label"] = "StdList";
-    res["cols"][3]["type"] = "number";
+template <typename K>
+static Json::Value get_json_template()
+{
+    Json::Value res = get_domain_template();
 
-    res["cols"][4]["id"] = "queuenaive";
-    res["cols"][4]["label"] = "QueueNaive";
-    res["cols"][4]["type"] = "number";
+    ColumnBuilder<K> builder = { res, domain_columns() - 1 };
+    for_each_container(Containers(), builder);
 
-    res["cols"][5]["id"] = "queuereclaiming";
-    res["cols"][5]["label"] = "QueueReclaiming";
-    res["cols"][5]["type"] = "number";
+    return res;
+}
 
-    res["cols"][6]["id"] = "queueconservative";
-    res["cols"][6]["label"] = "QueueConservative";
-    res["cols"][6]["type"] = "number";
+// outcome of a cell, sent back from workers as bytes
+struct CellResult {
+    Measurement m;
+    ElementCounts counts;
+};
 
-    res["cols"][7]["id"] = "dequenaive";
-    res["cols"][7]["label"] = "DequeNaive";
-    res["cols"][7]["type"] = "number";
+// counts of the last measured region of the calling thread
+static thread_local ElementCounts region_counts;
+static thread_local bool region_stopped = false;
 
-    res["cols"][8]["id"] = "dequereclaiming";
-    res["cols"][8]["label"] = "DequeReclaiming";
-    res["cols"][8]["type"] = "number";
+// Kernels read the clock at the start and the end of their measured region
+// with these, which also reset the element counters at the start and keep the
+// counts at the end, so that the untimed setup and teardown are not counted.
+static std::chrono::high_resolution_clock::time_point start_region()
+{
+    reset_element_counts();
+    return std::chrono::high_resolution_clock::now();
+}
 
-    res["cols"][9]["id"] = "dequeconservative";
-    res["cols"][9]["label"] = "DequeConservative";
-    res["cols"][9]["type"] = "number";
+static std::chrono::high_resolution_clock::time_point stop_region()
+{
+    auto t = std::chrono::high_resolution_clock::now();
+    region_counts = element_counts();
+    region_stopped = true;
+    return t;
+}
 
+// instrumented element types are counted in a separate call so that the
+// counters do not add to the measured time, with the counts of the whole call
+// for kernels without a measured region
+static CellResult run_cell(const Cell& cell)
+{
+    CellResult res = CellResult();
+    if (cell.counted) {
+        region_stopped = false;
+        reset_element_counts();
+        cell.run(cell.r.n);
+        res.counts = region_stopped ? region_counts : element_counts();
+    }
+    if (cell.r.metric != "ms") {
+        res.m = summarize(std::vector<double>(1, cell.run(cell.r.n)));
+    } else {
+        res.m = measure(cell.run, cell.r.n, options.runner);
+    }
+    if (cell.release) {
+        cell.release();
+    }
     return res;
 }
 
-template <typename Function>
-static double get_average(Function f, const size_t n)
+// stores the median in the chart cell with the spread shown in the tooltip,
+// unstable measurements are marked with '!' on progress
+static void finish_cell(Cell& cell, const CellResult& res)
+{
+    const Measurement& m = res.m;
+    cell.r.m = m;
+    cell.r.counted = cell.counted;
+    cell.r.counts = res.counts;
+    Json::Value& v = charts[cell.chart].data["rows"][cell.row]["c"][cell.col];
+
+    if (cell.r.metric != "ms") {
+        v["v"] = m.median;
+        std::cout << "." << std::flush;
+        return;
+    }
+
+    char buf[192];
+    snprintf(buf, sizeof(buf), "%.3f ms [%.3f, %.3f] MAD %.3f (%zux%zu) %.2f ns/op %.3g ops/s%s",
+             m.median, m.ci_low, m.ci_high, m.mad, m.samples, m.iterations,
+             cell.r.ns_per_op(), cell.r.ops_per_sec(), m.unstable ? " unstable" : "");
+    std::string tooltip = buf;
+    if (cell.counted) {
+        snprintf(buf, sizeof(buf), " %zu copies %zu moves %zu default %zu destructs",
+                 res.counts.copies(), res.counts.moves(), res.counts.default_constructs,
+                 res.counts.destructs);
+        tooltip += buf;
+    }
+
+    v["v"] = options.per_op ? cell.r.ns_per_op() : m.median;
+    v["f"] = tooltip;
+
+    if (m.unstable) {
+        unstable_count++;
+    }
+    std::cout << (m.unstable ? "!" : ".") << std::flush;
+}
+
+// runs a cell in this process, or in a freshly forked child with isolation,
+// returns false if the child dies
+static bool run_cell_isolated(const Cell& cell, CellResult& res)
+{
+    if (!options.isolate) {
+        res = run_cell(cell);
+        return true;
+    }
+    bool ok = run_isolated(
+        [&cell]() {
+            if (options.prewarm > 0) {
+                prewarm_heap(options.prewarm);
+            }
+            return run_cell(cell);
+        },
+        res);
+    if (!ok) {
+        std::cerr << "measurement of " << cell.r.test << cell.r.type << " for "
+                  << cell.r.container << " with n=" << cell.r.n << " died" << std::endl;
+    }
+    return ok;
+}
+
+// runs the given cells one after another in this process
+static bool run_serial(const std::vector<size_t>& indices)
+{
+    for (size_t k = 0; k < indices.size(); ++k) {
+        const size_t i = indices[k];
+        if (k == 0 || cells[i].chart != cells[indices[k - 1]].chart) {
+            std::cout << charts[cells[i].chart].name << " " << std::flush;
+        }
+        CellResult res;
+        if (!run_cell_isolated(cells[i], res)) {
+            return false;
+        }
+        finish_cell(cells[i], res);
+        if (k + 1 == indices.size() || cells[i].chart != cells[indices[k + 1]].chart) {
+            std::cout << " DONE" << std::endl;
+        }
+    }
+    return true;
+}
+
+// Runs all planned cells, either one after another in this process or spread
+// over worker processes pinned to separate cores when more jobs are requested.
+// Workers exit when an isolated measurement dies, which fails the whole run.
+// Cells of thread charts need more than one core, so they run in this process
+// after the workers are done instead, where they are not pinned.
+static bool run_cells()
 {
-    std::vector<double> timings;
-    for (int i = 0; i < 5; ++i) {
-        timings.push_back(f(n));
+    std::vector<size_t> pooled;
+    std::vector<size_t> serial;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        bool threads = charts[cells[i].chart].axis == "threads";
+        (options.jobs == 1 || threads ? serial : pooled).push_back(i);
+    }
+    if (pooled.empty()) {
+        return run_serial(serial);
+    }
+
+    std::vector<int> cpus = select_worker_cpus(options.jobs, options.one_per_llc);
+    if (cpus.empty()) {
+        std::cerr << "no cpus available for workers" << std::endl;
+        return false;
+    }
+    std::cout << "running " << pooled.size() << " measurements on " << cpus.size() << " workers (cpus";
+    for (const int cpu : cpus) {
+        std::cout << " " << cpu;
+    }
+    std::cout << ")" << std::endl;
+    if (share_llc(cpus)) {
+        std::cout << "warning: workers share a last level cache, use --one-per-llc to avoid it"
+                  << std::endl;
     }
 
-    // average of 3 runs out of 5 runs total exluding the best and the worst
-    std::sort(timings.begin(), timings.end());
-    return (timings[1] + timings[2] + timings[3] / 3.0);
+    bool ok = run_workers<CellResult>(
+        pooled.size(), cpus,
+        [&pooled](size_t k) {
+            CellResult res;
+            if (!run_cell_isolated(cells[pooled[k]], res)) {
+                _exit(EXIT_FAILURE);
+            }
+            return res;
+        },
+        [&pooled](size_t k, const CellResult& res) { finish_cell(cells[pooled[k]], res); });
+    std::cout << " DONE" << std::endl;
+    return ok && run_serial(serial);
 }
 
 template <template <typename> class Container, typename Type>
@@ -252,13 +570,13 @@ static double fill_back(const size_t n)
     using namespace std::chrono;
     Container<Type> c;
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = 0; i < n; ++i) {
         c.push_back(Type());
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -282,14 +600,14 @@ static double fill_back_reserved(const size_t n)
     using namespace std::chrono;
     Container<Type> c;
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     c.reserve_back(n);
     for (size_t i = 0; i < n; ++i) {
         c.push_back(Type());
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -301,13 +619,13 @@ static double fill_front(const size_t n)
     using namespace std::chrono;
     Container<Type> c;
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = 0; i < n; ++i) {
         c.push_front(Type());
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -331,14 +649,14 @@ static double fill_front_reserved(const size_t n)
     using namespace std::chrono;
     Container<Type> c;
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     c.reserve_front(n);
     for (size_t i = 0; i < n; ++i) {
         c.push_front(Type());
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -354,7 +672,7 @@ static double queue(const size_t n)
         c.push_back(Type());
     }
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = 0; i < n; ++i) {
         if (i % 2 == 0) {
@@ -364,7 +682,7 @@ static double queue(const size_t n)
         }
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -390,12 +708,143 @@ static double queue_memory(const size_t n)
     return total / n;
 }
 
+// queue test with the elements written to disk every sync_every operations
+template <template <typename> class Container, typename Type>
+static double queue_synced(const size_t n)
+{
+    using namespace std::chrono;
+    const int load = 1000;
+    Container<Type> c;
+    for (size_t i = 0; i < load; ++i) {
+        c.push_back(Type());
+    }
+    c.set_sync_interval(options.sync_every);
+
+    auto t1 = start_region();
+
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 2 == 0) {
+            c.push_back(Type());
+        } else {
+            c.pop_front();
+        }
+    }
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
+}
+
+// path of a new empty file in TMPDIR, or /tmp if it is not set
+static std::string temporary_path()
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/stl-bench-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        std::cerr << "cannot create temporary file '" << path << "'" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    close(fd);
+    return path;
+}
+
+static volatile size_t recover_sink;
+
+// Fills a queue file with n elements in a child process that exits without
+// closing it, as if it crashed, and times opening the file again and reading
+// the recovered elements. The file is still in the page cache, so this is the
+// recovery after a crash of the process rather than of the system.
+template <template <typename> class Container, typename Type>
+static double recover(const size_t n)
+{
+    using namespace std::chrono;
+    const std::string path = temporary_path();
+    pid_t pid = fork();
+    if (pid == 0) {
+        Container<Type> c;
+        if (!c.open(path)) {
+            _exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Type val;
+            val.data[0] = static_cast<int>(i);
+            c.push_back(val);
+        }
+        _exit(EXIT_SUCCESS);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        std::cerr << "cannot fill queue file '" << path << "'" << std::endl;
+        unlink(path.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto t1 = start_region();
+
+    Container<Type> c;
+    size_t sum = 0;
+    if (c.open(path)) {
+        for (size_t i = 0; i < c.size(); ++i) {
+            sum += c[i].data[0];
+        }
+    }
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    recover_sink = sum;
+    if (c.size() != n) {
+        std::cerr << "recovered " << c.size() << " of " << n << " elements from '" << path << "'" << std::endl;
+        unlink(path.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    unlink(path.c_str());
+    return time_span.count();
+}
+
+// In-memory containers survive a crash with a snapshot file instead, which is
+// written untimed here, and recovery reads it back into a new container.
+template <template <typename> class Container, typename Type>
+static double recover_snapshot(const size_t n)
+{
+    using namespace std::chrono;
+    const std::string path = temporary_path();
+    {
+        std::vector<Type> elements(n);
+        for (size_t i = 0; i < n; ++i) {
+            elements[i].data[0] = static_cast<int>(i);
+        }
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(elements.data()), n * sizeof(Type));
+    }
+
+    auto t1 = start_region();
+
+    Container<Type> c;
+    std::ifstream in(path, std::ios::binary);
+    std::vector<Type> buffer(4096);
+    while (in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(Type)) || in.gcount() > 0) {
+        size_t count = static_cast<size_t>(in.gcount()) / sizeof(Type);
+        for (size_t i = 0; i < count; ++i) {
+            c.push_back(buffer[i]);
+        }
+    }
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    unlink(path.c_str());
+    return time_span.count();
+}
+
 template <template <typename> class Container, typename Type>
 static double zigzag(const size_t n) {
     using namespace std::chrono;
     Container<Type> c;
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = 0; i < n / 4; ++i) {
         c.push_back(Type());
@@ -416,7 +865,7 @@ static double zigzag(const size_t n) {
         c.pop_front();
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
@@ -456,29 +905,73 @@ static double zigzag_memory(const size_t n)
     return total / (2 * n);
 }
 
+#if !defined(__x86_64__) && !defined(__i386__)
+// writes a buffer twice the size of the last level cache, one byte per line
+static void evict_caches()
+{
+    static std::vector<char> buffer;
+    if (buffer.empty()) {
+        std::vector<CacheLevel> levels = read_caches(0);
+        buffer.resize(2 * (levels.empty() ? 64 * 1024 * 1024 : levels.back().size));
+    }
+    for (size_t i = 0; i < buffer.size(); i += 64) {
+        buffer[i]++;
+    }
+}
+#endif
+
+// Flushes the cache lines of the first n elements of a container so that the
+// measured region starts with cold caches instead of the lines left by filling.
+// Other architectures stream over a buffer larger than the last level cache.
+template <typename C, typename Type>
+static void evict(C& c, const size_t n)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    uintptr_t last = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uintptr_t first = reinterpret_cast<uintptr_t>(&c[i]) & ~uintptr_t(63);
+        uintptr_t end = reinterpret_cast<uintptr_t>(&c[i]) + sizeof(Type);
+        for (uintptr_t line = first; line < end; line += 64) {
+            if (line != last) {
+                _mm_clflush(reinterpret_cast<const void*>(line));
+                last = line;
+            }
+        }
+    }
+    _mm_mfence();
+#else
+    (void)c;
+    (void)n;
+    evict_caches();
+#endif
+}
+
 template <template <typename> class Container, typename Type>
-static double traverse(const size_t n)
+static double traverse(const size_t n, const bool cold)
 {
     using namespace std::chrono;
     Container<Type> c;
     for (size_t i = 0; i < n; ++i) {
         c.push_back(Type());
     }
+    if (cold) {
+        evict<Container<Type>, Type>(c, n);
+    }
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = 0; i < n; ++i) {
-        c[i].data[0]++;
+        hot(c[i])++;
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
 }
 
 template <template <typename> class Container, typename Type>
-static double shuffle(const size_t n)
+static double shuffle(const size_t n, const bool cold)
 {
     using namespace std::chrono;
     Container<Type> c;
@@ -488,413 +981,2206 @@ static double shuffle(const size_t n)
     std::default_random_engine generator;
     std::uniform_int_distribution<size_t> distribution(0, n - 1);
     auto rand = std::bind(distribution, generator);
+    if (cold) {
+        evict<Container<Type>, Type>(c, n);
+    }
 
-    auto t1 = high_resolution_clock::now();
+    auto t1 = start_region();
 
     for (size_t i = n - 1; i > 0; --i) {
         std::swap(c[rand()], c[i]);
     }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
 }
 
-template <typename Container, typename Type>
-void qsort_helper(Container& arr, const size_t left, const size_t right)
+// Inserts each element in the middle of the elements so far, so that half of
+// them have to be moved whichever side is shifted.
+template <template <typename> class Container, typename Type>
+static double insert_middle(const size_t n)
 {
-    if (left < right && right + 1 != 0) {
-        Type pivot = arr[right];
-        size_t index = left;
-        for (size_t i = left; i < right; ++i) {
-            if (arr[i] < pivot) {
-                std::swap(arr[i], arr[index]);
-                index++;
-            }
-        }
-        arr[right] = arr[index];
-        arr[index] = pivot;
-        qsort_helper<Container, Type>(arr, left, index - 1);
-        qsort_helper<Container, Type>(arr, index + 1, right);
+    using namespace std::chrono;
+    Container<Type> c;
+
+    auto t1 = start_region();
+
+    for (size_t i = 0; i < n; ++i) {
+        c.insert(i / 2, Type());
     }
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
 template <template <typename> class Container, typename Type>
-static double qsort(const size_t n)
+static double erase_middle(const size_t n)
 {
     using namespace std::chrono;
     Container<Type> c;
     for (size_t i = 0; i < n; ++i) {
-        Type t;
-        t.data[0] = static_cast<int>(i);
-        c.push_back(t);
+        c.push_back(Type());
     }
-    std::default_random_engine generator;
-    std::uniform_int_distribution<size_t> distribution(0, n - 1);
-    auto rand = std::bind(distribution, generator);
 
-    for (size_t i = n - 1; i > 0; --i) {
-        std::swap(c[rand()], c[i]);
+    auto t1 = start_region();
+
+    for (size_t i = n; i > 0; --i) {
+        c.erase((i - 1) / 2);
     }
 
-    auto t1 = high_resolution_clock::now();
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
-    qsort_helper<Container<Type>, Type>(c, 0, n - 1);
+    return time_span.count();
+}
+
+// positions of random insertions, where the i-th one is uniform over the i + 1
+// positions of the elements so far
+static std::vector<size_t> insert_positions(const size_t n)
+{
+    std::default_random_engine generator;
+    std::vector<size_t> positions(n);
+    for (size_t i = 0; i < n; ++i) {
+        positions[i] = std::uniform_int_distribution<size_t>(0, i)(generator);
+    }
+    return positions;
+}
+
+template <template <typename> class Container, typename Type>
+static double insert_random(const size_t n)
+{
+    using namespace std::chrono;
+    const std::vector<size_t> positions = insert_positions(n);
+    Container<Type> c;
+
+    auto t1 = start_region();
+
+    for (size_t i = 0; i < n; ++i) {
+        c.insert(positions[i], Type());
+    }
 
-    auto t2 = high_resolution_clock::now();
+    auto t2 = stop_region();
     auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
     return time_span.count();
 }
 
-template <typename Type>
-static Json::Value fill_back_test(const size_t step)
+// the end of a chase is stored so that the loop is not optimized away
+static volatile size_t chase_sink;
+
+// Follows a single cycle through all elements where each index is read from
+// the previous element, so that accesses can not overlap and each one costs
+// the full latency of operator[]. The cycle is made with Sattolo's algorithm.
+template <template <typename> class Container, typename Type>
+static double chase(const size_t n)
 {
-    std::cout << "fill-back-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    std::vector<size_t> next(n);
+    for (size_t i = 0; i < n; ++i) {
+        next[i] = i;
+    }
+    std::default_random_engine generator;
+    for (size_t i = n - 1; i > 0; --i) {
+        std::uniform_int_distribution<size_t> distribution(0, i - 1);
+        std::swap(next[i], next[distribution(generator)]);
+    }
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    Container<Type> c;
+    for (size_t i = 0; i < n; ++i) {
+        Type t;
+        hot(t) = static_cast<int>(next[i]);
+        c.push_back(t);
+    }
 
-        get_average(fill_back<StdDeque, Type>, n); // warm-up
+    auto t1 = start_region();
 
-        res["rows"][i]["c"][1]["v"] = get_average(fill_back<StdVector, Type>, n);          std::cout << "." << std::flush;
-        res["rows"][i]["c"][2]["v"] = get_average(fill_back<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(fill_back<StdList, Type>, n);            std::cout << "." << std::flush;
-        res["rows"][i]["c"][4]["v"] = get_average(fill_back<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(fill_back<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(fill_back<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(fill_back<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(fill_back<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(fill_back<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+    size_t ind = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ind = static_cast<size_t>(hot(c[ind]));
     }
+    chase_sink = ind;
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value fill_back_memory_test(const size_t step)
+template <typename Container, typename Type>
+void qsort_helper(Container& arr, const size_t left, const size_t right)
 {
-    std::cout << "fill-back-memory-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    if (left < right && right + 1 != 0) {
+        Type pivot = arr[right];
+        size_t index = left;
+        for (size_t i = left; i < right; ++i) {
+            if (arr[i] < pivot) {
+                std::swap(arr[i], arr[index]);
+                index++;
+            }
+        }
+        arr[right] = arr[index];
+        arr[index] = pivot;
+        qsort_helper<Container, Type>(arr, left, index - 1);
+        qsort_helper<Container, Type>(arr, index + 1, right);
+    }
+}
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+template <template <typename> class Container, typename Type>
+static double qsort(const size_t n, const bool cold)
+{
+    using namespace std::chrono;
+    Container<Type> c;
+    for (size_t i = 0; i < n; ++i) {
+        Type t;
+        hot(t) = static_cast<int>(i);
+        c.push_back(t);
+    }
+    std::default_random_engine generator;
+    std::uniform_int_distribution<size_t> distribution(0, n - 1);
+    auto rand = std::bind(distribution, generator);
 
-        res["rows"][i]["c"][1]["v"] = fill_back_memory<StdVector, Type>(n);          std::cout << "." << std::flush;
-        res["cols"][2]["label"] = "(NR)StdDeque";
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["rows"][i]["c"][4]["v"] = fill_back_memory<QueueNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = fill_back_memory<QueueReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = fill_back_memory<QueueConservative, Type>(n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = fill_back_memory<DequeNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = fill_back_memory<DequeReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = fill_back_memory<DequeConservative, Type>(n);  std::cout << "." << std::flush;
+    for (size_t i = n - 1; i > 0; --i) {
+        std::swap(c[rand()], c[i]);
+    }
+    if (cold) {
+        evict<Container<Type>, Type>(c, n);
     }
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t1 = start_region();
+
+    qsort_helper<Container<Type>, Type>(c, 0, n - 1);
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value fill_back_reserved_test(const size_t step)
+// results of the algorithm tests, kept so that they are not optimized away
+static volatile size_t algorithm_sink;
+
+// Fills the container with the values 0 to n-1, shuffled unless the algorithm
+// needs sorted input, and times the algorithm over IndexIterator.
+template <template <typename> class Container, typename Type, typename Algorithm>
+static double algorithm(const size_t n)
 {
-    std::cout << "fill-back-reserved-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    Container<Type> c;
+    for (size_t i = 0; i < n; ++i) {
+        Type t;
+        hot(t) = static_cast<int>(i);
+        c.push_back(t);
+    }
+    if (!Algorithm::sorted) {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<size_t> distribution(0, n - 1);
+        auto rand = std::bind(distribution, generator);
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+        for (size_t i = n - 1; i > 0; --i) {
+            std::swap(c[rand()], c[i]);
+        }
+    }
 
-        get_average(fill_back<StdDeque, Type>, n); // warm-up
+    auto t1 = start_region();
 
-        res["rows"][i]["c"][1]["v"] = get_average(fill_back_reserved<StdVector, Type>, n);          std::cout << "." << std::flush;
-        res["rows"][i]["c"][2]["v"] = get_average(fill_back<StdDeque, Type>, n);                    std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(fill_back<StdList, Type>, n);                     std::cout << "." << std::flush;
-        res["rows"][i]["c"][4]["v"] = get_average(fill_back_reserved<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(fill_back_reserved<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(fill_back_reserved<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(fill_back_reserved<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(fill_back_reserved<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(fill_back_reserved<DequeConservative, Type>, n);  std::cout << "." << std::flush;
-    }
+    Algorithm::apply(index_begin(c), index_end(c, n), n);
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value fill_front_test(const size_t step)
+// random keys of the heap tests, the same for each call
+static std::vector<int> heap_keys(const size_t n)
 {
-    std::cout << "fill-front-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> distribution(0, static_cast<int>(n));
+    std::vector<int> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = distribution(generator);
+    }
+    return keys;
+}
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+template <template <typename> class Container, typename Type, size_t Arity>
+static double heap_push(const size_t n)
+{
+    using namespace std::chrono;
+    const std::vector<int> keys = heap_keys(n);
+    DaryHeap<Container<Type>, Type, Arity> heap;
 
-        get_average(fill_front<StdDeque, Type>, n); // warm-up
+    auto t1 = start_region();
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["rows"][i]["c"][2]["v"] = get_average(fill_front<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(fill_front<StdList, Type>, n);            std::cout << "." << std::flush;
-        res["cols"][4]["label"] = "(NR)QueueNaive";
-        res["cols"][5]["label"] = "(NR)QueueReclaiming";
-        res["cols"][6]["label"] = "(NR)QueueConservative";
-        res["rows"][i]["c"][7]["v"] = get_average(fill_front<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(fill_front<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(fill_front<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+    for (size_t i = 0; i < n; ++i) {
+        Type t;
+        hot(t) = keys[i];
+        heap.push(t);
     }
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value fill_front_memory_test(const size_t step)
+// pops all elements of a heap filled with random keys
+template <template <typename> class Container, typename Type, size_t Arity>
+static double heap_pop(const size_t n)
 {
-    std::cout << "fill-front-memory-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    const std::vector<int> keys = heap_keys(n);
+    DaryHeap<Container<Type>, Type, Arity> heap;
+    for (size_t i = 0; i < n; ++i) {
+        Type t;
+        hot(t) = keys[i];
+        heap.push(t);
+    }
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    auto t1 = start_region();
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["cols"][2]["label"] = "(NR)StdDeque";
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["cols"][4]["label"] = "(NR)QueueNaive";
-        res["cols"][5]["label"] = "(NR)QueueReclaiming";
-        res["cols"][6]["label"] = "(NR)QueueConservative";
-        res["rows"][i]["c"][7]["v"] = fill_front_memory<DequeNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = fill_front_memory<DequeReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = fill_front_memory<DequeConservative, Type>(n);  std::cout << "." << std::flush;
+    size_t sum = 0;
+    while (!heap.empty()) {
+        sum += hot(heap.top());
+        heap.pop();
     }
+    algorithm_sink = sum;
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
+}
+
+// operations that a container may not have are compiled in only if it does,
+// traces are only replayed on containers supporting all of their operations
+template <unsigned Op, typename C>
+using Supported = std::integral_constant<bool, supports(C::operations, Op)>;
+
+template <typename C, typename Type>
+struct ReplayOps {
+    static void push_back(C& c, std::true_type) { c.push_back(Type()); }
+    static void push_back(C&, std::false_type) {}
+    static void pop_back(C& c, std::true_type) { c.pop_back(); }
+    static void pop_back(C&, std::false_type) {}
+    static void push_front(C& c, std::true_type) { c.push_front(Type()); }
+    static void push_front(C&, std::false_type) {}
+    static void pop_front(C& c, std::true_type) { c.pop_front(); }
+    static void pop_front(C&, std::false_type) {}
+    static void index(C& c, const size_t ind, std::true_type) { hot(c[ind])++; }
+    static void index(C&, const size_t, std::false_type) {}
+};
+
+template <typename C>
+struct SeamOps {
+    static size_t seam(C& c, std::true_type) { return c.seam(); }
+    static size_t seam(C&, std::false_type) { return 0; }
+};
+
+// Splits the indices [0, n) into about equal ranges for the given number of
+// threads, returned as boundaries. Containers made of two arrays (i.e. the
+// Deque* classes) are split at their seam first, with threads given to each
+// array in proportion to its size, so that no range spans both arrays.
+template <typename C>
+static std::vector<size_t> split_ranges(C& c, const size_t n, const size_t threads)
+{
+    const size_t seam = std::min(SeamOps<C>::seam(c, Supported<OP_SEAM, C>()), n);
+    size_t front = 0;
+    if (threads > 1 && seam > 0 && seam < n) {
+        front = std::max<size_t>(1, std::min((threads * seam + n / 2) / n, threads - 1));
+    }
+
+    std::vector<size_t> bounds(1, 0);
+    for (size_t t = 1; t <= front; ++t) {
+        bounds.push_back(seam * t / front);
+    }
+    const size_t start = bounds.back();
+    const size_t back = threads - front;
+    for (size_t t = 1; t <= back; ++t) {
+        bounds.push_back(start + (n - start) * t / back);
+    }
+    return bounds;
 }
 
-template <typename Type>
-static Json::Value fill_front_reserved_test(const size_t step)
+// Runs work(i) for each of the given number of parts in a thread of its own,
+// except the last part which is run in the calling thread, so that a single
+// part does not start any threads.
+template <typename Work>
+static void parallel_for(const size_t parts, Work work)
 {
-    std::cout << "fill-front-reserved-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i + 1 < parts; ++i) {
+        pool.emplace_back(work, i);
+    }
+    work(parts - 1);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+// Fills half of the elements from the front when the container can, so that
+// the Deque* classes hold elements in both of their arrays, and sets the values
+// 0 to n-1 in order, or shuffled.
+template <typename C, typename Type>
+static void fill_both_ends(C& c, const size_t n, const bool shuffled)
+{
+    typedef ReplayOps<C, Type> Ops;
+    const bool front = Supported<OP_PUSH_FRONT, C>::value;
+    for (size_t i = 0; i < n; ++i) {
+        if (front && i % 2 == 0) {
+            Ops::push_front(c, Supported<OP_PUSH_FRONT, C>());
+        } else {
+            c.push_back(Type());
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        hot(c[i]) = static_cast<int>(i);
+    }
+    if (shuffled) {
+        std::default_random_engine generator;
+        std::uniform_int_distribution<size_t> distribution(0, n - 1);
+        auto rand = std::bind(distribution, generator);
 
-        get_average(fill_front<StdDeque, Type>, n); // warm-up
+        for (size_t i = n - 1; i > 0; --i) {
+            std::swap(c[rand()], c[i]);
+        }
+    }
+}
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["rows"][i]["c"][2]["v"] = get_average(fill_front<StdDeque, Type>, n);                    std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(fill_front<StdList, Type>, n);                     std::cout << "." << std::flush;
-        res["rows"][i]["c"][4]["v"] = get_average(fill_front_reserved<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(fill_front_reserved<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(fill_front_reserved<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(fill_front_reserved<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(fill_front_reserved<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(fill_front_reserved<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+// Sorts each range in its own thread and merges pairs of adjacent ranges in
+// parallel rounds until a single range is left, i.e. a merge sort with the
+// ranges as leaves. Threads are started within the measured region as they
+// would be in a task parallel sort.
+template <template <typename> class Container, typename Type>
+static double parallel_sort(const size_t threads, const size_t n)
+{
+    using namespace std::chrono;
+    Container<Type> c;
+    fill_both_ends<Container<Type>, Type>(c, n, true);
+    std::vector<size_t> bounds = split_ranges(c, n, threads);
+    const IndexIterator<Container<Type>> first = index_begin(c);
+
+    auto t1 = start_region();
+
+    parallel_for(bounds.size() - 1, [&first, &bounds](size_t i) {
+        std::sort(first + bounds[i], first + bounds[i + 1]);
+    });
+    while (bounds.size() > 2) {
+        const size_t ranges = bounds.size() - 1;
+        parallel_for(ranges / 2, [&first, &bounds](size_t i) {
+            std::inplace_merge(first + bounds[2 * i], first + bounds[2 * i + 1], first + bounds[2 * i + 2]);
+        });
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) {
+            merged.push_back(bounds[i]);
+        }
+        if (ranges % 2 == 1) {
+            merged.push_back(bounds.back());
+        }
+        bounds = merged;
     }
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value queue_test(const size_t step)
+// increments every element, each thread over its own range
+template <template <typename> class Container, typename Type>
+static double parallel_for_each(const size_t threads, const size_t n)
 {
-    std::cout << "queue-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    Container<Type> c;
+    fill_both_ends<Container<Type>, Type>(c, n, false);
+    const std::vector<size_t> bounds = split_ranges(c, n, threads);
+    const IndexIterator<Container<Type>> first = index_begin(c);
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    auto t1 = start_region();
 
-        get_average(queue<StdDeque, Type>, n); // warm-up
+    parallel_for(bounds.size() - 1, [&first, &bounds](size_t i) {
+        std::for_each(first + bounds[i], first + bounds[i + 1], [](Type& t) { hot(t)++; });
+    });
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["rows"][i]["c"][2]["v"] = get_average(queue<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(queue<StdList, Type>, n);            std::cout << "." << std::flush;
-        res["rows"][i]["c"][4]["v"] = get_average(queue<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(queue<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(queue<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(queue<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(queue<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(queue<DequeConservative, Type>, n);  std::cout << "." << std::flush;
-    }
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value queue_memory_test(const size_t step)
+// sums the elements with a partial sum per thread
+template <template <typename> class Container, typename Type>
+static double parallel_reduce(const size_t threads, const size_t n)
 {
-    std::cout << "queue-memory-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    Container<Type> c;
+    fill_both_ends<Container<Type>, Type>(c, n, false);
+    const std::vector<size_t> bounds = split_ranges(c, n, threads);
+    const IndexIterator<Container<Type>> first = index_begin(c);
+    std::vector<size_t> sums(bounds.size() - 1);
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    auto t1 = start_region();
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["cols"][2]["label"] = "(NR)StdDeque";
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["rows"][i]["c"][4]["v"] = queue_memory<QueueNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = queue_memory<QueueReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = queue_memory<QueueConservative, Type>(n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = queue_memory<DequeNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = queue_memory<DequeReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = queue_memory<DequeConservative, Type>(n);  std::cout << "." << std::flush;
-    }
+    parallel_for(bounds.size() - 1, [&first, &bounds, &sums](size_t i) {
+        sums[i] = std::accumulate(first + bounds[i], first + bounds[i + 1], size_t(0),
+                                  [](size_t sum, Type& t) { return sum + hot(t); });
+    });
+    algorithm_sink = std::accumulate(sums.begin(), sums.end(), size_t(0));
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
+}
+
+// Applies n trace records to a container of the given size. Pops on an empty
+// container are skipped and indices wrap around the size so that any trace can
+// be replayed.
+template <typename C, typename Type>
+static void apply_records(C& c, size_t& size, const uint32_t* records, const size_t n)
+{
+    typedef ReplayOps<C, Type> Ops;
+
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t record = records[i];
+        switch (trace_opcode(record)) {
+        case TRACE_PUSH_BACK:
+            Ops::push_back(c, Supported<OP_PUSH_BACK, C>());
+            size++;
+            break;
+        case TRACE_POP_BACK:
+            if (size > 0) {
+                Ops::pop_back(c, Supported<OP_POP_BACK, C>());
+                size--;
+            }
+            break;
+        case TRACE_PUSH_FRONT:
+            Ops::push_front(c, Supported<OP_PUSH_FRONT, C>());
+            size++;
+            break;
+        case TRACE_POP_FRONT:
+            if (size > 0) {
+                Ops::pop_front(c, Supported<OP_POP_FRONT, C>());
+                size--;
+            }
+            break;
+        default:
+            if (size > 0) {
+                size_t ind = trace_operand(record);
+                Ops::index(c, ind < size ? ind : ind % size, Supported<OP_RANDOM_ACCESS, C>());
+            }
+            break;
+        }
+    }
 }
 
-template <typename Type>
-static Json::Value zigzag_test(const size_t step)
+// replays warmup records untimed and then times the next n records
+template <template <typename> class Container, typename Type>
+static double replay(const uint32_t* records, const size_t warmup, const size_t n)
 {
-    std::cout << "zigzag-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    Container<Type> c;
+    size_t size = 0;
+    apply_records<Container<Type>, Type>(c, size, records, warmup);
+
+    auto t1 = start_region();
+
+    apply_records<Container<Type>, Type>(c, size, records + warmup, n);
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
+}
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+// Records of the last generated workload, which are shared by all containers.
+// They are freed after each measurement, since the fill and operations of a
+// depth of 10^7 take 80 MB, which would otherwise stay for the whole run.
+static WorkloadSpec workload_spec;
+static size_t workload_ops = 0;
+static size_t workload_warmup = 0;
+static std::vector<uint32_t> workload_records;
 
-        get_average(zigzag<StdDeque, Type>, n); // warm-up
+static void release_workload()
+{
+    std::vector<uint32_t>().swap(workload_records);
+}
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["rows"][i]["c"][2]["v"] = get_average(zigzag<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["rows"][i]["c"][3]["v"] = get_average(zigzag<StdList, Type>, n);            std::cout << "." << std::flush;
-        res["cols"][4]["label"] = "(NR)QueueNaive";
-        res["cols"][5]["label"] = "(NR)QueueReclaiming";
-        res["cols"][6]["label"] = "(NR)QueueConservative";
-        res["rows"][i]["c"][7]["v"] = get_average(zigzag<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(zigzag<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(zigzag<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+// Generates the records of a workload once for the repeated calls of a
+// measurement and replays them.
+template <template <typename> class Container, typename Type>
+static double workload(const WorkloadSpec& spec, const size_t ops)
+{
+    if (workload_records.empty() || spec != workload_spec || ops != workload_ops) {
+        release_workload();
+        workload_warmup = generate_workload(spec, ops, workload_records);
+        workload_spec = spec;
+        workload_ops = ops;
     }
+    return replay<Container, Type>(workload_records.data(), workload_warmup, ops);
+}
 
-    std::cout << " DONE" << std::endl;
-    return res;
+// queue operations at a fixed depth, timing at least base operations so that
+// the untimed fill does not dominate small depths
+static WorkloadSpec queue_depth_spec(const size_t depth)
+{
+    WorkloadSpec spec;
+    spec.depth = depth;
+    return spec;
+}
+
+static size_t queue_depth_ops(const size_t depth)
+{
+    const size_t base = 10000;
+    return depth > base ? depth : base;
 }
 
-template <typename Type>
-static Json::Value zigzag_memory_test(const size_t step)
+// queue depth oscillating by an eighth around the given depth four times per
+// call, which makes policies that grow and shrink at the same size thrash when
+// the depth is a power of two, i.e. a capacity boundary of doubling growth
+static WorkloadSpec oscillation_spec(const size_t depth)
 {
-    std::cout << "zigzag-memory-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    WorkloadSpec spec = queue_depth_spec(depth);
+    spec.amplitude = 0.125;
+    spec.period = queue_depth_ops(depth) / 4;
+    return spec;
+}
+
+// a burst of pushes (positive length) or pops (negative length) on one of the
+// live containers of a churn test
+struct ChurnBurst {
+    uint32_t container;
+    int32_t length;
+};
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+static const int32_t churn_burst = 32;   // mean burst length
+static const size_t churn_limit = 1024; // size at which containers start to shrink
 
-        res["cols"][1]["label"] = "(NR)StdVector";
-        res["cols"][2]["label"] = "(NR)StdDeque";
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["cols"][4]["label"] = "(NR)QueueNaive";
-        res["cols"][5]["label"] = "(NR)QueueReclaiming";
-        res["cols"][6]["label"] = "(NR)QueueConservative";
-        res["rows"][i]["c"][7]["v"] = zigzag_memory<DequeNaive, Type>(n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = zigzag_memory<DequeReclaiming, Type>(n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = zigzag_memory<DequeConservative, Type>(n);  std::cout << "." << std::flush;
+// Generates bursts adding up to n operations over the live containers, after a
+// burst for each container filling it to a random initial size. Containers are
+// picked with a skewed distribution so that they grow and shrink at different
+// rates, and stay in a growing or shrinking phase for a random number of
+// bursts. Returns the number of fill bursts.
+static size_t generate_churn(const size_t containers, const size_t n, std::vector<ChurnBurst>& bursts)
+{
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::uniform_int_distribution<int32_t> length(1, 2 * churn_burst - 1);
+    std::vector<size_t> sizes(containers);
+    std::vector<bool> growing(containers);
+
+    bursts.clear();
+    for (size_t i = 0; i < containers; ++i) {
+        int32_t len = length(gen) * 4;
+        sizes[i] = static_cast<size_t>(len);
+        growing[i] = unit(gen) < 0.5;
+        bursts.push_back({ static_cast<uint32_t>(i), len });
+    }
+    const size_t fill = bursts.size();
+
+    size_t ops = 0;
+    while (ops < n) {
+        double u = unit(gen);
+        size_t i = static_cast<size_t>(u * u * containers);
+        if (growing[i] ? sizes[i] >= churn_limit : sizes[i] == 0) {
+            growing[i] = !growing[i];
+        }
+        size_t len = std::min(static_cast<size_t>(length(gen)), n - ops);
+        if (!growing[i]) {
+            len = std::min(len, sizes[i]);
+        }
+        int32_t signed_len = static_cast<int32_t>(len);
+        bursts.push_back({ static_cast<uint32_t>(i), growing[i] ? signed_len : -signed_len });
+        sizes[i] = growing[i] ? sizes[i] + len : sizes[i] - len;
+        ops += len;
+        if (unit(gen) < 0.25) {
+            growing[i] = !growing[i];
+        }
     }
+    return fill;
+}
 
-    std::cout << " DONE" << std::endl;
-    return res;
+// Generates the bursts of a churn test once for the repeated calls of a
+// measurement.
+static const std::vector<ChurnBurst>& churn_bursts(const size_t n, size_t& fill)
+{
+    static size_t last_n = 0;
+    static size_t last_containers = 0;
+    static size_t last_fill = 0;
+    static std::vector<ChurnBurst> bursts;
+    if (bursts.empty() || n != last_n || options.churn != last_containers) {
+        last_fill = generate_churn(options.churn, n, bursts);
+        last_n = n;
+        last_containers = options.churn;
+    }
+    fill = last_fill;
+    return bursts;
+}
+
+template <typename C, typename Type>
+static void apply_churn(std::vector<C>& cs, const ChurnBurst* bursts, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        C& c = cs[bursts[i].container];
+        if (bursts[i].length > 0) {
+            for (int32_t j = 0; j < bursts[i].length; ++j) {
+                c.push_back(Type());
+            }
+        } else {
+            for (int32_t j = 0; j < -bursts[i].length; ++j) {
+                c.pop_front();
+            }
+        }
+    }
 }
 
-template <typename Type>
-static Json::Value traverse_test(const size_t step)
+// fills the live containers untimed and then times n operations over them
+template <template <typename> class Container, typename Type>
+static double churn(const size_t n)
 {
-    std::cout << "traverse-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    using namespace std::chrono;
+    size_t fill;
+    const std::vector<ChurnBurst>& bursts = churn_bursts(n, fill);
+    std::vector<Container<Type>> cs(options.churn);
+    apply_churn<Container<Type>, Type>(cs, bursts.data(), fill);
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    auto t1 = start_region();
 
-        get_average(traverse<StdDeque, Type>, n); // warm-up
+    apply_churn<Container<Type>, Type>(cs, bursts.data() + fill, bursts.size() - fill);
 
-        res["rows"][i]["c"][1]["v"] = get_average(traverse<StdVector, Type>, n);          std::cout << "." << std::flush;
-        res["rows"][i]["c"][2]["v"] = get_average(traverse<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["rows"][i]["c"][4]["v"] = get_average(traverse<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(traverse<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(traverse<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(traverse<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(traverse<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(traverse<DequeConservative, Type>, n);  std::cout << "." << std::flush;
-    }
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    return time_span.count();
+}
+
+// growth of the resident set in MB after n operations with all containers live
+template <template <typename> class Container, typename Type>
+static double churn_rss(const size_t n)
+{
+    size_t fill;
+    const std::vector<ChurnBurst>& bursts = churn_bursts(n, fill);
+    const size_t base = resident_bytes();
+    std::vector<Container<Type>> cs(options.churn);
+    apply_churn<Container<Type>, Type>(cs, bursts.data(), bursts.size());
+    const size_t rss = resident_bytes();
+    return rss > base ? (rss - base) / (1024.0 * 1024.0) : 0;
 }
 
-template <typename Type>
-static Json::Value shuffle_test(const size_t step)
+// Generates the lengths of short lived containers once for the repeated calls
+// of a measurement, adding up to n pushes. Lengths are log uniform up to 4096,
+// so that most containers are short and a few grow through many sizes.
+static const std::vector<size_t>& short_lengths(const size_t n)
 {
-    std::cout << "shuffle-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
+    static size_t last_n = 0;
+    static std::vector<size_t> lengths;
+    if (n != last_n) {
+        std::default_random_engine generator;
+        std::uniform_real_distribution<double> distribution(0, 12);
+        lengths.clear();
+        size_t total = 0;
+        while (total < n) {
+            size_t length = static_cast<size_t>(std::exp2(distribution(generator)));
+            length = std::min(length, n - total);
+            lengths.push_back(length);
+            total += length;
+        }
+        last_n = n;
+    }
+    return lengths;
+}
 
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+// builds, fills and destroys one container after another with n pushes in all
+template <template <typename> class Container, typename Type>
+static double short_lived(const size_t n)
+{
+    using namespace std::chrono;
+    const std::vector<size_t>& lengths = short_lengths(n);
 
-        get_average(shuffle<StdDeque, Type>, n); // warm-up
+    auto t1 = start_region();
 
-        res["rows"][i]["c"][1]["v"] = get_average(shuffle<StdVector, Type>, n);          std::cout << "." << std::flush;
-        res["rows"][i]["c"][2]["v"] = get_average(shuffle<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["rows"][i]["c"][4]["v"] = get_average(shuffle<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(shuffle<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(shuffle<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(shuffle<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(shuffle<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(shuffle<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+    for (size_t length : lengths) {
+        Container<Type> c;
+        for (size_t i = 0; i < length; ++i) {
+            c.push_back(Type());
+        }
     }
 
-    std::cout << " DONE" << std::endl;
-    return res;
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
 }
 
-template <typename Type>
-static Json::Value qsort_test(const size_t step)
+// free fraction of the heap after n operations with all containers live
+template <template <typename> class Container, typename Type>
+static double churn_fragmentation(const size_t n)
 {
-    std::cout << "qsort-test<" << typeid(Type).name() << "> " << std::flush;
-    Json::Value res = get_json_template();
-
-    for (int i = 0; i < 10; ++i) {
-        size_t n = static_cast<size_t>(i + 1) * step;
-        res["rows"][i]["c"][0]["v"] = std::to_string(n);
+    size_t fill;
+    const std::vector<ChurnBurst>& bursts = churn_bursts(n, fill);
+    std::vector<Container<Type>> cs(options.churn);
+    apply_churn<Container<Type>, Type>(cs, bursts.data(), bursts.size());
+    return heap_fragmentation();
+}
 
-        get_average(qsort<StdDeque, Type>, n); // warm-up
+// event streams of the window tests
+enum WindowStream {
+    STREAM_UNIFORM,    // random values
+    STREAM_INCREASING, // each event dominates the whole window
+    STREAM_DECREASING, // the window fills up and expires from the front
+    STREAM_WALK,       // random steps of one up or down
+};
 
-        res["rows"][i]["c"][1]["v"] = get_average(qsort<StdVector, Type>, n);          std::cout << "." << std::flush;
-        res["rows"][i]["c"][2]["v"] = get_average(qsort<StdDeque, Type>, n);           std::cout << "." << std::flush;
-        res["cols"][3]["label"] = "(NR)StdList";
-        res["rows"][i]["c"][4]["v"] = get_average(qsort<QueueNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][5]["v"] = get_average(qsort<QueueReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][6]["v"] = get_average(qsort<QueueConservative, Type>, n);  std::cout << "." << std::flush;
-        res["rows"][i]["c"][7]["v"] = get_average(qsort<DequeNaive, Type>, n);         std::cout << "." << std::flush;
-        res["rows"][i]["c"][8]["v"] = get_average(qsort<DequeReclaiming, Type>, n);    std::cout << "." << std::flush;
-        res["rows"][i]["c"][9]["v"] = get_average(qsort<DequeConservative, Type>, n);  std::cout << "." << std::flush;
+static const char* stream_name(const WindowStream stream)
+{
+    switch (stream) {
+    case STREAM_INCREASING:
+        return "Increasing";
+    case STREAM_DECREASING:
+        return "Decreasing";
+    case STREAM_WALK:
+        return "Walk";
+    default:
+        return "Uniform";
     }
+}
 
-    std::cout << " DONE" << std::endl;
-    return res;
+// number of events of a window test, at least four windows
+static size_t window_events(const size_t window)
+{
+    const size_t base = 100000;
+    return window * 4 > base ? window * 4 : base;
 }
 
-int main()
+// Generates the values of a stream once for the repeated calls of a
+// measurement.
+static const std::vector<int>& window_values(const WindowStream stream, const size_t events)
 {
-    std::ofstream html_file("charts.html");
-    run_tests_and_print_html(html_file);
-    html_file.close();
+    static WindowStream last_stream = STREAM_UNIFORM;
+    static std::vector<int> values;
+    if (values.size() == events && stream == last_stream) {
+        return values;
+    }
+    std::default_random_engine generator;
+    std::uniform_int_distribution<int> distribution(0, 1 << 20);
+    values.resize(events);
+    int walk = 0;
+    for (size_t i = 0; i < events; ++i) {
+        switch (stream) {
+        case STREAM_UNIFORM:
+            values[i] = distribution(generator);
+            break;
+        case STREAM_INCREASING:
+            values[i] = static_cast<int>(i);
+            break;
+        case STREAM_DECREASING:
+            values[i] = -static_cast<int>(i);
+            break;
+        case STREAM_WALK:
+            walk += distribution(generator) % 2 == 0 ? 1 : -1;
+            values[i] = walk;
+            break;
+        }
+    }
+    last_stream = stream;
+    return values;
+}
+
+// Adds event i to the monotonic deque of a sliding window maximum, which holds
+// the indices of events with decreasing values, and returns the maximum of the
+// window ending at the event. Dominated events are popped from the back and
+// expired events from the front.
+template <typename C, typename Type>
+static int window_step(C& c, size_t& size, const std::vector<int>& values, const size_t i, const size_t window)
+{
+    const int val = values[i];
+    while (size > 0 && values[hot(c.back())] <= val) {
+        c.pop_back();
+        size--;
+    }
+    Type t;
+    hot(t) = static_cast<int>(i);
+    c.push_back(t);
+    size++;
+    if (static_cast<size_t>(hot(c.front())) + window <= i) {
+        c.pop_front();
+        size--;
+    }
+    return values[hot(c.front())];
+}
+
+template <template <typename> class Container, typename Type>
+static double sliding_window(const WindowStream stream, const size_t window)
+{
+    using namespace std::chrono;
+    const size_t events = window_events(window);
+    const std::vector<int>& values = window_values(stream, events);
+    Container<Type> c;
+    size_t size = 0;
+    long long sum = 0;
+
+    auto t1 = start_region();
+
+    for (size_t i = 0; i < events; ++i) {
+        sum += window_step<Container<Type>, Type>(c, size, values, i, window);
+    }
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+    algorithm_sink = static_cast<size_t>(sum);
+
+    return time_span.count();
+}
+
+template <template <typename> class Container, typename Type>
+static double sliding_window_memory(const WindowStream stream, const size_t window)
+{
+    const size_t events = window_events(window);
+    const std::vector<int>& values = window_values(stream, events);
+    double total = 0;
+    Container<Type> c;
+    size_t size = 0;
+    for (size_t i = 0; i < events; ++i) {
+        window_step<Container<Type>, Type>(c, size, values, i, window);
+        total += c.load_factor();
+    }
+    return total / events;
+}
+
+// Generates a graph once for the repeated calls of a measurement.
+static const Graph& bfs_graph(const GraphKind kind, const size_t n)
+{
+    static GraphKind last_kind = GRAPH_GRID;
+    static size_t last_n = 0;
+    static Graph graph;
+    if (graph.offsets.empty() || kind != last_kind || n != last_n) {
+        generate_graph(kind, n, graph);
+        last_kind = kind;
+        last_n = n;
+    }
+    return graph;
+}
+
+// Breadth first search from vertex 0 with the container as the frontier.
+// Calls level() with the frontier size whenever the search moves on to the
+// next level, and returns the number of reached vertices.
+template <typename C, typename Type, typename Level>
+static size_t bfs_search(C& frontier, const Graph& graph, std::vector<uint32_t>& depth, Level level)
+{
+    const uint32_t unseen = UINT32_MAX;
+    std::fill(depth.begin(), depth.end(), unseen);
+    Type t;
+    hot(t) = 0;
+    frontier.push_back(t);
+    depth[0] = 0;
+    size_t size = 1;
+    size_t reached = 1;
+    uint32_t current = 0;
+    while (size > 0) {
+        const uint32_t v = static_cast<uint32_t>(hot(frontier.front()));
+        frontier.pop_front();
+        size--;
+        if (depth[v] != current) {
+            current = depth[v];
+            level(size + 1);
+        }
+        for (uint32_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            const uint32_t u = graph.edges[e];
+            if (depth[u] == unseen) {
+                depth[u] = depth[v] + 1;
+                hot(t) = static_cast<int>(u);
+                frontier.push_back(t);
+                size++;
+                reached++;
+            }
+        }
+    }
+    return reached;
+}
+
+template <template <typename> class Container, typename Type>
+static double bfs(const GraphKind kind, const size_t n)
+{
+    using namespace std::chrono;
+    const Graph& graph = bfs_graph(kind, n);
+    std::vector<uint32_t> depth(graph.vertices());
+    Container<Type> frontier;
+
+    auto t1 = start_region();
+
+    algorithm_sink = bfs_search<Container<Type>, Type>(frontier, graph, depth, [](size_t) {});
+
+    auto t2 = stop_region();
+    auto time_span = duration_cast<duration<double, std::milli>>(t2 - t1);
+
+    return time_span.count();
+}
+
+// Peak heap usage of the frontier in MB, sampled from the allocator at every
+// level, as frontier sizes swing widely between levels.
+template <template <typename> class Container, typename Type>
+static double bfs_memory(const GraphKind kind, const size_t n)
+{
+    const Graph& graph = bfs_graph(kind, n);
+    std::vector<uint32_t> depth(graph.vertices());
+    const size_t base = heap_in_use();
+    size_t peak = base;
+    Container<Type> frontier;
+    bfs_search<Container<Type>, Type>(frontier, graph, depth, [&peak](size_t) {
+        peak = std::max(peak, heap_in_use());
+    });
+    peak = std::max(peak, heap_in_use());
+    return (peak - base) / (1024.0 * 1024.0);
+}
+
+struct FillBack : Kernel {
+    static const char* name() { return "FillBack"; }
+    static const unsigned required = OP_PUSH_BACK;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_back<Container, Type>(n); }
+};
+
+// containers without reserve_back use values from the regular fill back test
+struct FillBackReserved : Kernel {
+    static const char* name() { return "FillBackReserved"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RESERVE_BACK;
+    typedef FillBack fallback;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_back_reserved<Container, Type>(n); }
+};
+
+struct FillFront : Kernel {
+    static const char* name() { return "FillFront"; }
+    static const unsigned required = OP_PUSH_FRONT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_front<Container, Type>(n); }
+};
+
+// pushes to the front are cheap after reserve_front even for queues
+struct FillFrontReserved : Kernel {
+    static const char* name() { return "FillFrontReserved"; }
+    static const unsigned required = OP_RESERVE_FRONT;
+    typedef FillFront fallback;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_front_reserved<Container, Type>(n); }
+};
+
+struct Queue : Kernel {
+    static const char* name() { return "Queue"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+    static const unsigned opt_in = OP_PERSISTENT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return queue<Container, Type>(n); }
+};
+
+// containers that are not persistent use values from the regular queue test
+struct QueueSynced : Kernel {
+    static const char* name() { return "QueueSynced"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT | OP_PERSISTENT;
+    typedef Queue fallback;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return queue_synced<Container, Type>(n); }
+};
+
+struct RecoverSnapshot : Kernel {
+    static const char* name() { return "RecoverSnapshot"; }
+    static const unsigned required = OP_PUSH_BACK;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return recover_snapshot<Container, Type>(n); }
+};
+
+// sizes are elements written before the crash, and containers that are not
+// persistent recover from a snapshot file
+struct Recover : Kernel {
+    static const char* name() { return "Recover"; }
+    static const unsigned required = OP_PERSISTENT;
+    typedef RecoverSnapshot fallback;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return recover<Container, Type>(n); }
+};
+
+struct Zigzag : Kernel {
+    static const char* name() { return "Zigzag"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT | OP_POP_FRONT;
+
+    static double operations(const size_t n) { return 2.0 * n; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return zigzag<Container, Type>(n); }
+};
+
+struct Traverse : Kernel {
+    static const char* name() { return "Traverse"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const unsigned opt_in = OP_PERSISTENT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return traverse<Container, Type>(n, false); }
+};
+
+// cold variants evict the elements from caches before the measured region
+struct TraverseCold : Traverse {
+    static const char* name() { return "TraverseCold"; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return traverse<Container, Type>(n, true); }
+};
+
+struct Shuffle : Kernel {
+    static const char* name() { return "Shuffle"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return shuffle<Container, Type>(n, false); }
+};
+
+struct ShuffleCold : Shuffle {
+    static const char* name() { return "ShuffleCold"; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return shuffle<Container, Type>(n, true); }
+};
+
+struct QSort : Kernel {
+    static const char* name() { return "QSort"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const Complexity expected = O_N_LOG_N;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return qsort<Container, Type>(n, false); }
+};
+
+struct QSortCold : QSort {
+    static const char* name() { return "QSortCold"; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return qsort<Container, Type>(n, true); }
+};
+
+// middle insertions move n / 4 elements on average, so both tests are
+// quadratic and run at small sizes
+struct InsertMiddle : Kernel {
+    static const char* name() { return "InsertMiddle"; }
+    static const unsigned required = OP_INSERT;
+    static const size_t max_scale = 1;
+    static const size_t max_elements = 10000;
+    static const Complexity expected = O_N2;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return insert_middle<Container, Type>(n); }
+};
+
+struct EraseMiddle : Kernel {
+    static const char* name() { return "EraseMiddle"; }
+    static const unsigned required = OP_PUSH_BACK | OP_INSERT;
+    static const size_t max_scale = 1;
+    static const size_t max_elements = 10000;
+    static const Complexity expected = O_N2;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return erase_middle<Container, Type>(n); }
+};
+
+// random insertions move or walk over n / 8 elements on average for containers
+// using the shorter side and n / 4 for StdVector, so they are quadratic except
+// for TieredVector
+struct InsertRandom : Kernel {
+    static const char* name() { return "InsertRandom"; }
+    static const unsigned required = OP_INSERT;
+    static const size_t max_scale = 1;
+    static const size_t max_elements = 10000;
+    static const Complexity expected = O_N2;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return insert_random<Container, Type>(n); }
+};
+
+struct Chase : Kernel {
+    static const char* name() { return "Chase"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const unsigned opt_in = OP_PERSISTENT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return chase<Container, Type>(n); }
+};
+
+// Chase for all containers including StdList, at small sizes as its linear
+// operator[] makes the test quadratic
+struct ChaseAll : Kernel {
+    static const char* name() { return "ChaseAll"; }
+    static const unsigned required = OP_PUSH_BACK;
+    static const size_t max_scale = 1;
+    static const size_t max_elements = 10000;
+    static const Complexity expected = O_N2;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return chase<Container, Type>(n); }
+};
+
+// Algorithm tests run standard algorithms over IndexIterator, so every
+// element access goes through operator[] of the container.
+struct Sort : Kernel {
+    static const char* name() { return "Sort"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const Complexity expected = O_N_LOG_N;
+    static const bool sorted = false;
+
+    template <typename It>
+    static void apply(It first, It last, size_t) { std::sort(first, last); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, Sort>(n); }
+};
+
+struct StableSort : Sort {
+    static const char* name() { return "StableSort"; }
+
+    template <typename It>
+    static void apply(It first, It last, size_t) { std::stable_sort(first, last); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, StableSort>(n); }
+};
+
+// selects the median
+struct NthElement : Kernel {
+    static const char* name() { return "NthElement"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const bool sorted = false;
+
+    template <typename It>
+    static void apply(It first, It last, const size_t n) { std::nth_element(first, first + n / 2, last); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, NthElement>(n); }
+};
+
+// n binary searches of scattered keys
+struct LowerBound : Kernel {
+    static const char* name() { return "LowerBound"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const Complexity expected = O_N_LOG_N;
+    static const bool sorted = true;
+
+    template <typename It>
+    static void apply(It first, It last, const size_t n)
+    {
+        typedef typename std::iterator_traits<It>::value_type T;
+        size_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int key = static_cast<int>(i * 2654435761u % n);
+            sum += std::lower_bound(first, last, key, [](T& t, int k) { return hot(t) < k; }) - first;
+        }
+        algorithm_sink = sum;
+    }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, LowerBound>(n); }
+};
+
+struct Accumulate : Kernel {
+    static const char* name() { return "Accumulate"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const bool sorted = true;
+
+    template <typename It>
+    static void apply(It first, It last, size_t)
+    {
+        typedef typename std::iterator_traits<It>::value_type T;
+        algorithm_sink = std::accumulate(first, last, size_t(0), [](size_t sum, T& t) { return sum + hot(t); });
+    }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, Accumulate>(n); }
+};
+
+// searches for the last element so that the whole container is scanned
+struct FindIf : Kernel {
+    static const char* name() { return "FindIf"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const bool sorted = true;
+
+    template <typename It>
+    static void apply(It first, It last, const size_t n)
+    {
+        typedef typename std::iterator_traits<It>::value_type T;
+        int key = static_cast<int>(n - 1);
+        algorithm_sink = std::find_if(first, last, [key](T& t) { return hot(t) == key; }) - first;
+    }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, FindIf>(n); }
+};
+
+// rotates by a third so that the cycles of the rotation do not line up
+struct Rotate : Kernel {
+    static const char* name() { return "Rotate"; }
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+    static const bool sorted = true;
+
+    template <typename It>
+    static void apply(It first, It last, const size_t n) { std::rotate(first, first + n / 3, last); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return algorithm<Container, Type, Rotate>(n); }
+};
+
+// Graph tests run a breadth first search with the container as the frontier,
+// e.g. "BfsGrid", sizes are numbers of vertices and operations are edges.
+template <GraphKind Kind>
+struct Bfs : Kernel {
+    static const char* name()
+    {
+        static const std::string str = std::string("Bfs") + graph_name(Kind);
+        return str.c_str();
+    }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    static double operations(const size_t n) { return static_cast<double>(graph_edges(Kind, n)); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return bfs<Container, Type>(Kind, n); }
+};
+
+template <GraphKind Kind>
+struct BfsMemory : Kernel {
+    static const char* name()
+    {
+        static const std::string str = std::string("Bfs") + graph_name(Kind) + "Memory";
+        return str.c_str();
+    }
+    static const char* metric() { return "heap"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return bfs_memory<Container, Type>(Kind, n); }
+};
+
+// sizes are window sizes, e.g. "WindowUniform" for random event values
+template <WindowStream Stream>
+struct Window : Kernel {
+    static const char* name()
+    {
+        static const std::string str = std::string("Window") + stream_name(Stream);
+        return str.c_str();
+    }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_BACK | OP_POP_FRONT;
+
+    static double operations(const size_t n) { return static_cast<double>(window_events(n)); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return sliding_window<Container, Type>(Stream, n); }
+};
+
+template <WindowStream Stream>
+struct WindowMemory : Kernel {
+    static const char* name()
+    {
+        static const std::string str = std::string("Window") + stream_name(Stream) + "Memory";
+        return str.c_str();
+    }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_BACK | OP_POP_FRONT | OP_LOAD_FACTOR;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return sliding_window_memory<Container, Type>(Stream, n); }
+};
+
+// Heap tests run DaryHeap with the given arity on top of the container, e.g.
+// "HeapPush4" for a 4-ary heap.
+template <size_t Arity>
+struct HeapPush : Kernel {
+    static const char* name()
+    {
+        static const std::string str = "HeapPush" + std::to_string(Arity);
+        return str.c_str();
+    }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const Complexity expected = O_N_LOG_N;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return heap_push<Container, Type, Arity>(n); }
+};
+
+template <size_t Arity>
+struct HeapPop : Kernel {
+    static const char* name()
+    {
+        static const std::string str = "HeapPop" + std::to_string(Arity);
+        return str.c_str();
+    }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_BACK | OP_RANDOM_ACCESS;
+    static const size_t max_scale = 10;
+    static const Complexity expected = O_N_LOG_N;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return heap_pop<Container, Type, Arity>(n); }
+};
+
+// Parallel kernels split the work on a single container over threads, sizes
+// are numbers of elements regardless of the number of threads.
+struct ParallelKernel : Kernel {
+    static const unsigned required = OP_PUSH_BACK | OP_RANDOM_ACCESS;
+
+    static double thread_operations(const size_t n, size_t) { return static_cast<double>(n); }
+};
+
+struct ParallelSort : ParallelKernel {
+    static const char* name() { return "ParallelSort"; }
+    static const size_t max_scale = 10;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t threads, const size_t n) { return parallel_sort<Container, Type>(threads, n); }
+};
+
+struct ParallelForEach : ParallelKernel {
+    static const char* name() { return "ParallelForEach"; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t threads, const size_t n) { return parallel_for_each<Container, Type>(threads, n); }
+};
+
+struct ParallelReduce : ParallelKernel {
+    static const char* name() { return "ParallelReduce"; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t threads, const size_t n) { return parallel_reduce<Container, Type>(threads, n); }
+};
+
+// sizes are queue depths rather than numbers of operations
+struct QueueDepth : Kernel {
+    static const char* name() { return "QueueDepth"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    static double operations(const size_t n) { return static_cast<double>(queue_depth_ops(n)); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return workload<Container, Type>(queue_depth_spec(n), queue_depth_ops(n)); }
+
+    static void release() { release_workload(); }
+};
+
+struct QueueOscillation : Kernel {
+    static const char* name() { return "QueueOscillation"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    static double operations(const size_t n) { return static_cast<double>(queue_depth_ops(n)); }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return workload<Container, Type>(oscillation_spec(n), queue_depth_ops(n)); }
+
+    static void release() { release_workload(); }
+};
+
+// sizes are numbers of operations spread over the live containers
+struct Churn : Kernel {
+    static const char* name() { return "Churn"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return churn<Container, Type>(n); }
+};
+
+struct ChurnRss : Kernel {
+    static const char* name() { return "ChurnRss"; }
+    static const char* metric() { return "rss"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return churn_rss<Container, Type>(n); }
+};
+
+struct ChurnFragmentation : Kernel {
+    static const char* name() { return "ChurnFragmentation"; }
+    static const char* metric() { return "fragmentation"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return churn_fragmentation<Container, Type>(n); }
+};
+
+struct ShortLived : Kernel {
+    static const char* name() { return "ShortLived"; }
+    static const unsigned required = OP_PUSH_BACK;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return short_lived<Container, Type>(n); }
+};
+
+// Runs a kernel with the buffer cache of the calling thread enabled, e.g.
+// "ChurnCached", which is emptied after each run. These tests are only
+// planned in builds with BENCH_BUFFER_CACHE, where containers use the cache.
+template <typename K>
+struct Cached : K {
+    static const char* name()
+    {
+        static const std::string str = std::string(K::name()) + "Cached";
+        return str.c_str();
+    }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n)
+    {
+        BufferCacheScope scope(options.cache_limit, options.cache_class_limit);
+        return K::template run<Container, Type>(n);
+    }
+};
+
+struct FillBackMemory : Kernel {
+    static const char* name() { return "FillBackMemory"; }
+    static const unsigned required = OP_PUSH_BACK | OP_LOAD_FACTOR;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_back_memory<Container, Type>(n); }
+};
+
+struct FillFrontMemory : Kernel {
+    static const char* name() { return "FillFrontMemory"; }
+    static const unsigned required = OP_PUSH_FRONT | OP_LOAD_FACTOR;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return fill_front_memory<Container, Type>(n); }
+};
+
+struct QueueMemory : Kernel {
+    static const char* name() { return "QueueMemory"; }
+    static const unsigned required = OP_PUSH_BACK | OP_POP_FRONT | OP_LOAD_FACTOR;
+    static const unsigned opt_in = OP_PERSISTENT;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return queue_memory<Container, Type>(n); }
+};
+
+struct ZigzagMemory : Kernel {
+    static const char* name() { return "ZigzagMemory"; }
+    static const unsigned required = Zigzag::required | OP_LOAD_FACTOR;
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t n) { return zigzag_memory<Container, Type>(n); }
+};
+
+// plans the cells of a row for each container in the registry, columns of
+// containers resolving to NotRun are left empty
+template <typename K, typename Type, bool Memory>
+struct RowBuilder {
+    size_t chart;
+    Json::ArrayIndex row;
+    size_t n;
+    int col;
+
+    template <template <typename> class Container>
+    void operator()(ContainerTag<Container>)
+    {
+        col++;
+        set_cell(static_cast<typename Resolve<K, Container>::type*>(nullptr), ContainerTag<Container>());
+    }
+
+    template <template <typename> class Container>
+    void set_cell(NotRun*, ContainerTag<Container>)
+    {
+    }
+
+    template <typename R, template <typename> class Container>
+    void set_cell(R*, ContainerTag<Container>)
+    {
+        if (!selected_column(charts[chart].data, col)) {
+            return;
+        }
+
+        Cell cell;
+        cell.r.test = K::name();
+        cell.r.type = Type::name();
+        cell.r.container = Container<Type>::name();
+        cell.r.n = n;
+        if (Memory) {
+            cell.r.metric = R::metric();
+        } else {
+            cell.r.metric = "ms";
+            cell.r.ops = R::operations(n);
+            cell.r.expected = R::expected;
+        }
+        cell.run = R::template run<Container, Type>;
+        cell.release = R::release;
+        cell.counted = is_counted<Type>::value;
+        cell.chart = chart;
+        cell.row = row;
+        cell.col = col;
+        cells.push_back(cell);
+    }
+};
+
+template <typename K, typename Type, bool Memory>
+static void plan_test(const std::string& test_name, const std::vector<size_t>& sizes)
+{
+    Chart chart;
+    chart.name = test_name;
+    chart.memory = Memory;
+    chart.metric = K::metric();
+    chart.axis = domain_title();
+    chart.data = get_json_template<K>();
+    charts.push_back(chart);
+
+    for (Json::ArrayIndex i = 0; i < sizes.size(); ++i) {
+        size_t n = sizes[i];
+        Json::Value& row = charts.back().data["rows"][i];
+        if (options.sweep == "cache") {
+            size_t prev = i > 0 ? sizes[i - 1] * sizeof(Type) : 0;
+            std::string boundaries = cache_boundaries(prev, n * sizeof(Type));
+            row["c"][0]["v"] = std::to_string(n);
+            row["c"][0]["f"] = format_bytes(n * sizeof(Type));
+            row["c"][1]["v"] = boundaries.empty() ? Json::Value() : Json::Value(boundaries);
+        } else {
+            row["c"][0]["v"] = std::to_string(n);
+        }
+
+        RowBuilder<K, Type, Memory> builder = { charts.size() - 1, i, n, domain_columns() - 1 };
+        for_each_container(Containers(), builder);
+    }
+}
+
+// Runs a kernel in the given number of threads at once, each on its own
+// container, and returns the time of the slowest thread. Threads wait for each
+// other before starting so that their measured parts overlap.
+template <typename K, template <typename> class Container, typename Type>
+static double run_threads(const size_t threads, const size_t n)
+{
+    std::vector<double> times(threads);
+    std::vector<std::thread> pool;
+    std::atomic<size_t> ready(0);
+    for (size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&times, &ready, threads, n, t]() {
+            ready++;
+            while (ready.load() < threads) {
+                std::this_thread::yield();
+            }
+            times[t] = K::template run<Container, Type>(n);
+        });
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    return *std::max_element(times.begin(), times.end());
+}
+
+// Runs a kernel in each thread on its own container, e.g. "QueueThreads", so
+// that threads only share the allocator.
+template <typename K>
+struct PerThread : K {
+    static const char* name()
+    {
+        static const std::string str = std::string(K::name()) + "Threads";
+        return str.c_str();
+    }
+
+    static double thread_operations(const size_t n, const size_t threads) { return K::operations(n) * threads; }
+
+    template <template <typename> class Container, typename Type>
+    static double run(const size_t threads, const size_t n) { return run_threads<K, Container, Type>(threads, n); }
+};
+
+template <typename K>
+struct ThreadRowBuilder {
+    size_t chart;
+    Json::ArrayIndex row;
+    size_t n;
+    size_t threads;
+    int col;
+
+    template <template <typename> class Container>
+    void operator()(ContainerTag<Container>)
+    {
+        col++;
+        set_cell(static_cast<typename Resolve<K, Container>::type*>(nullptr), ContainerTag<Container>());
+    }
+
+    template <template <typename> class Container>
+    void set_cell(NotRun*, ContainerTag<Container>)
+    {
+    }
+
+    template <typename R, template <typename> class Container>
+    void set_cell(R*, ContainerTag<Container>)
+    {
+        if (!selected_column(charts[chart].data, col)) {
+            return;
+        }
+
+        const size_t t = threads;
+        Cell cell;
+        cell.r.test = K::name();
+        cell.r.type = Small::name();
+        cell.r.container = Container<Small>::name();
+        cell.r.n = n;
+        cell.r.threads = t;
+        cell.r.metric = "ms";
+        cell.r.ops = R::thread_operations(n, t);
+        cell.run = [t](size_t n) { return R::template run<Container, Small>(t, n); };
+        cell.release = R::release;
+        cell.counted = false;
+        cell.chart = chart;
+        cell.row = row;
+        cell.col = col;
+        cells.push_back(cell);
+    }
+};
+
+// Thread tests run a kernel for Small elements with the largest size of its
+// timing test, and plot against the number of threads, which doubles from one
+// up to the threads option (or the number of usable cpus). They can also be
+// selected all together with the "Threads" family name.
+template <typename K>
+static void plan_thread_test()
+{
+    std::string name = K::name();
+    bool all = matches(options.tests, "Threads") && matches(options.types, Small::name());
+    if (!all && !selected(name, Small::name())) {
+        return;
+    }
+
+    size_t limit = options.threads > 0 ? options.threads : allowed_cpus().size();
+    std::vector<size_t> counts;
+    for (size_t t = 1; t < limit; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(limit > 0 ? limit : 1);
+
+    Chart chart;
+    chart.name = name;
+    chart.memory = false;
+    chart.axis = "threads";
+    chart.data = get_json_template<K>();
+    charts.push_back(chart);
+
+    size_t step = (Small::scale < K::max_scale ? Small::scale : K::max_scale) * options.scale;
+    size_t n = get_sizes(step, sizeof(Small)).back();
+    for (Json::ArrayIndex i = 0; i < counts.size(); ++i) {
+        charts.back().data["rows"][i]["c"][0]["v"] = std::to_string(counts[i]);
+        ThreadRowBuilder<K> builder = { charts.size() - 1, i, n, counts[i], domain_columns() - 1 };
+        for_each_container(Containers(), builder);
+    }
+}
+
+// plans a timing test for each element type in the registry
+template <typename K>
+struct TimingTests {
+    template <typename Type>
+    void operator()(TypeTag<Type>)
+    {
+        if (selected(K::name(), Type::name())) {
+            std::string test_name = std::string(K::name()) + Type::name();
+            size_t step = (Type::scale < K::max_scale ? Type::scale : K::max_scale) * options.scale;
+            plan_test<K, Type, false>(test_name, get_sizes(step, sizeof(Type), K::max_elements));
+        }
+    }
+};
+
+template <typename K, typename Types = ElementTypes>
+static void plan_timing_tests()
+{
+    TimingTests<K> tests;
+    for_each_type(Types(), tests);
+}
+
+// memory tests are only run for Small elements as load factors do not depend on
+// the element size
+template <typename K>
+static void plan_memory_test()
+{
+    if (selected(K::name(), Small::name())) {
+        plan_test<K, Small, true>(K::name(), get_sizes(Small::scale * options.scale, sizeof(Small)));
+    }
+}
+
+// graph tests are only run for Small elements, which hold vertex ids
+template <typename K, bool Memory>
+static void plan_graph_test()
+{
+    if (selected(K::name(), Small::name())) {
+        plan_test<K, Small, Memory>(K::name(), get_sizes(Small::scale * options.scale, sizeof(Small)));
+    }
+}
+
+// Depth tests are only run for Small elements as depths go up to 10^7 for
+// which larger elements do not fit in memory. Depths are powers of the given
+// factor (ten by default) up to the limit unless sizes are given or a cache
+// sweep is requested. Window tests are planned the same way with window sizes
+// as depths.
+template <typename K, bool Memory = false>
+static void plan_depth_test(const size_t limit = 10000000, const size_t factor = 10)
+{
+    if (!selected(K::name(), Small::name())) {
+        return;
+    }
+    std::vector<size_t> sizes = get_sizes(0, sizeof(Small));
+    if (options.sizes.empty() && options.sweep == "linear") {
+        sizes.clear();
+        for (size_t depth = 1; depth <= limit; depth *= factor) {
+            sizes.push_back(depth);
+        }
+    }
+    plan_test<K, Small, Memory>(K::name(), sizes);
+}
+
+// plans a row for each blob size with as many elements as fit in the footprint
+template <typename K>
+struct BlobRows {
+    size_t chart;
+    Json::ArrayIndex row;
+
+    template <typename Type>
+    void operator()(TypeTag<Type>)
+    {
+        size_t n = options.footprint / sizeof(Type);
+        charts[chart].data["rows"][row]["c"][0]["v"] = std::to_string(sizeof(Type));
+
+        RowBuilder<K, Type, false> builder = { chart, row, n > 0 ? n : 1, domain_columns() - 1 };
+        for_each_container(Containers(), builder);
+        row++;
+    }
+};
+
+// element size sweeps are run as "Blob" element type of a test, e.g. the
+// "FillBackBlob" chart, and plot against the element size
+template <typename K>
+static void plan_blob_test()
+{
+    if (!selected(K::name(), "Blob")) {
+        return;
+    }
+    Chart chart;
+    chart.name = std::string(K::name()) + "Blob";
+    chart.memory = false;
+    chart.axis = "element size (bytes)";
+    chart.data = get_json_template<K>();
+    charts.push_back(chart);
+
+    BlobRows<K> rows = { charts.size() - 1, 0 };
+    for_each_type(BlobTypes(), rows);
+}
+
+// test names are used in the generated javascript, so only alphanumeric
+// characters of the label are kept, e.g. "prod-queue" becomes "ProdQueue"
+static std::string dynamic_test_name(const std::string& family, const std::string& label)
+{
+    std::string name = family;
+    bool upper = true;
+    for (const char ch : label) {
+        if (std::isalnum(static_cast<unsigned char>(ch))) {
+            name += upper ? static_cast<char>(std::toupper(ch)) : ch;
+            upper = false;
+        } else {
+            upper = true;
+        }
+    }
+    return name;
+}
+
+// test name from the file name of a trace, e.g. "traces/prod-queue.trace"
+// becomes "ReplayProdQueue"
+static std::string replay_test_name(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    std::string stem = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    return dynamic_test_name("Replay", stem.substr(0, stem.find('.')));
+}
+
+// a trace file replayed from the start, sizes are prefix lengths
+struct TraceSource {
+    const TraceFile* trace;
+
+    unsigned operations() const { return trace->operations(); }
+
+    template <template <typename> class Container, typename Type>
+    double run(const size_t n) const { return replay<Container, Type>(trace->begin(), 0, n); }
+
+    static void release() {}
+};
+
+// a workload given on the command line, sizes are numbers of operations
+struct WorkloadSource {
+    WorkloadSpec spec;
+
+    unsigned operations() const { return workload_operations(spec); }
+
+    template <template <typename> class Container, typename Type>
+    double run(const size_t n) const { return workload<Container, Type>(spec, n); }
+
+    static void release() { release_workload(); }
+};
+
+// Columns of tests whose operations are only known at run time, i.e. traces
+// and workloads. Containers not supporting all of them are labeled as not run.
+struct DynamicColumnBuilder {
+    Json::Value& res;
+    int col;
+    unsigned required;
+
+    template <template <typename> class Container>
+    void operator()(ContainerTag<Container>)
+    {
+        std::string label = Container<char>::name();
+        if (!runs(Container<char>::operations, required, 0)) {
+            label = "(NR)" + label;
+        }
+        col++;
+        res["cols"][col]["id"] = to_lower(Container<char>::name());
+        res["cols"][col]["label"] = label;
+        res["cols"][col]["type"] = "number";
+    }
+};
+
+template <typename Type, typename Source>
+struct DynamicRowBuilder {
+    size_t chart;
+    Json::ArrayIndex row;
+    size_t n;
+    int col;
+    Source source;
+    std::string test;
+
+    template <template <typename> class Container>
+    void operator()(ContainerTag<Container>)
+    {
+        col++;
+        if (!runs(Container<Type>::operations, source.operations(), 0) ||
+            !selected_column(charts[chart].data, col)) {
+            return;
+        }
+
+        Source s = source;
+        Cell cell;
+        cell.r.test = test;
+        cell.r.type = Type::name();
+        cell.r.container = Container<Type>::name();
+        cell.r.n = n;
+        cell.r.metric = "ms";
+        cell.r.ops = static_cast<double>(n);
+        cell.run = [s](size_t n) { return s.template run<Container, Type>(n); };
+        cell.release = Source::release;
+        cell.counted = is_counted<Type>::value;
+        cell.chart = chart;
+        cell.row = row;
+        cell.col = col;
+        cells.push_back(cell);
+    }
+};
+
+// plans a dynamic test for each element type in the registry, which can also
+// be selected by the family name (e.g. "Replay") for all tests of a kind
+template <typename Source>
+struct DynamicTests {
+    Source source;
+    std::string name;
+    std::string family;
+    std::vector<size_t> sizes;
+
+    template <typename Type>
+    void operator()(TypeTag<Type>)
+    {
+        bool all = matches(options.tests, family) && matches(options.types, Type::name());
+        if (!all && !selected(name, Type::name())) {
+            return;
+        }
+
+        Chart chart;
+        chart.name = name + Type::name();
+        chart.memory = false;
+        chart.axis = domain_title();
+        chart.data = get_domain_template();
+        DynamicColumnBuilder columns = { chart.data, domain_columns() - 1, source.operations() };
+        for_each_container(Containers(), columns);
+        charts.push_back(chart);
+
+        for (Json::ArrayIndex i = 0; i < sizes.size(); ++i) {
+            charts.back().data["rows"][i]["c"][0]["v"] = std::to_string(sizes[i]);
+            DynamicRowBuilder<Type, Source> builder = { charts.size() - 1, i, sizes[i], domain_columns() - 1,
+                                                        source, name };
+            for_each_container(Containers(), builder);
+        }
+    }
+};
+
+// sizes given on the command line up to the limit, or linear steps otherwise
+static std::vector<size_t> get_dynamic_sizes(const size_t step, const size_t limit)
+{
+    std::vector<size_t> sizes;
+    for (const size_t n : options.sizes) {
+        if (n > 0 && n <= limit) {
+            sizes.push_back(n);
+        }
+    }
+    if (options.sizes.empty()) {
+        for (size_t i = 0; i < options.steps && (i + 1) * step <= limit; ++i) {
+            sizes.push_back((i + 1) * step);
+        }
+    }
+    return sizes;
+}
+
+static void plan_tests()
+{
+    plan_timing_tests<FillBack>();
+    plan_timing_tests<FillBackReserved>();
+    plan_timing_tests<FillFront>();
+    plan_timing_tests<FillFrontReserved>();
+    plan_timing_tests<Queue>();
+    plan_timing_tests<QueueSynced>();
+    plan_timing_tests<Zigzag>();
+    plan_timing_tests<Traverse>();
+    plan_timing_tests<TraverseCold>();
+    plan_timing_tests<Shuffle>();
+    plan_timing_tests<ShuffleCold>();
+    plan_timing_tests<QSort>();
+    plan_timing_tests<QSortCold>();
+    plan_timing_tests<InsertMiddle>();
+    plan_timing_tests<EraseMiddle>();
+    plan_timing_tests<InsertRandom>();
+    plan_timing_tests<Chase>();
+    plan_timing_tests<ChaseAll>();
+    plan_timing_tests<Sort>();
+    plan_timing_tests<StableSort>();
+    plan_timing_tests<NthElement>();
+    plan_timing_tests<LowerBound>();
+    plan_timing_tests<Accumulate>();
+    plan_timing_tests<FindIf>();
+    plan_timing_tests<Rotate>();
+    plan_timing_tests<Recover, PlainTypes>();
+    plan_timing_tests<Churn>();
+#ifdef BENCH_BUFFER_CACHE
+    plan_timing_tests<Cached<Churn>>();
+#endif
+    plan_timing_tests<ShortLived>();
+#ifdef BENCH_BUFFER_CACHE
+    plan_timing_tests<Cached<ShortLived>>();
+#endif
+    plan_timing_tests<HeapPush<2>, HeapTypes>();
+    plan_timing_tests<HeapPush<4>, HeapTypes>();
+    plan_timing_tests<HeapPush<8>, HeapTypes>();
+    plan_timing_tests<HeapPush<16>, HeapTypes>();
+    plan_timing_tests<HeapPop<2>, HeapTypes>();
+    plan_timing_tests<HeapPop<4>, HeapTypes>();
+    plan_timing_tests<HeapPop<8>, HeapTypes>();
+    plan_timing_tests<HeapPop<16>, HeapTypes>();
+
+    plan_memory_test<FillBackMemory>();
+    plan_memory_test<FillFrontMemory>();
+    plan_memory_test<QueueMemory>();
+    plan_memory_test<ZigzagMemory>();
+    plan_memory_test<ChurnRss>();
+#ifdef BENCH_BUFFER_CACHE
+    plan_memory_test<Cached<ChurnRss>>();
+#endif
+    plan_memory_test<ChurnFragmentation>();
+
+    plan_blob_test<FillBack>();
+    plan_blob_test<FillFront>();
+    plan_blob_test<Queue>();
+    plan_blob_test<Traverse>();
+    plan_blob_test<Shuffle>();
+    plan_blob_test<QSort>();
+
+    plan_depth_test<QueueDepth>();
+    plan_depth_test<QueueOscillation>(10000000, 8);
+
+    plan_graph_test<Bfs<GRAPH_GRID>, false>();
+    plan_graph_test<Bfs<GRAPH_REGULAR>, false>();
+    plan_graph_test<Bfs<GRAPH_POWER_LAW>, false>();
+    plan_graph_test<BfsMemory<GRAPH_GRID>, true>();
+    plan_graph_test<BfsMemory<GRAPH_REGULAR>, true>();
+    plan_graph_test<BfsMemory<GRAPH_POWER_LAW>, true>();
+
+    plan_depth_test<Window<STREAM_UNIFORM>>(1000000);
+    plan_depth_test<Window<STREAM_INCREASING>>(1000000);
+    plan_depth_test<Window<STREAM_DECREASING>>(1000000);
+    plan_depth_test<Window<STREAM_WALK>>(1000000);
+    plan_depth_test<WindowMemory<STREAM_UNIFORM>, true>(1000000);
+    plan_depth_test<WindowMemory<STREAM_INCREASING>, true>(1000000);
+    plan_depth_test<WindowMemory<STREAM_DECREASING>, true>(1000000);
+    plan_depth_test<WindowMemory<STREAM_WALK>, true>(1000000);
+
+    plan_thread_test<PerThread<FillBack>>();
+    plan_thread_test<PerThread<FillFront>>();
+    plan_thread_test<PerThread<Queue>>();
+    plan_thread_test<PerThread<Zigzag>>();
+    plan_thread_test<ParallelSort>();
+    plan_thread_test<ParallelForEach>();
+    plan_thread_test<ParallelReduce>();
+
+    for (size_t i = 0; i < traces.size(); ++i) {
+        TraceSource source = { &traces[i] };
+        size_t step = std::max<size_t>(traces[i].size() / options.steps, 1);
+        DynamicTests<TraceSource> tests = { source, replay_test_name(options.traces[i]), "Replay",
+                                            get_dynamic_sizes(step, traces[i].size()) };
+        for_each_type(ElementTypes(), tests);
+    }
+
+    for (size_t i = 0; i < workloads.size(); ++i) {
+        WorkloadSource source = { workloads[i] };
+        std::string label = workloads[i].name.empty() ? std::to_string(i + 1) : workloads[i].name;
+        std::string name = dynamic_test_name("Workload", label);
+        DynamicTests<WorkloadSource> tests = { source, name, "Workload",
+                                               get_dynamic_sizes(Small::scale * options.scale, SIZE_MAX) };
+        for_each_type(ElementTypes(), tests);
+    }
+}
+
+static void print_html(std::ofstream& out)
+{
+    out << " <html>" << std::endl;
+    out << "   <head>" << std::endl;
+    out << "     <!--Load the AJAX API-->" << std::endl;
+    out << "     <script type='text/javascript' "
+           "src='https://www.google.com/jsapi'></script>" << std::endl;
+    out << "     <script type='text/javascript' "
+           "src='//ajax.googleapis.com/ajax/libs/jquery/1.10.2/jquery.min.js'></"
+           "script>" << std::endl;
+    out << "     <script type='text/javascript'>" << std::endl;
+    out << std::endl;
+    out << "     google.load('visualization', '1', {'packages':['corechart']});"
+        << std::endl;
+    out << std::endl;
+    out << "     google.setOnLoadCallback(drawChart);" << std::endl;
+    out << std::endl;
+    out << "     function drawChart() {" << std::endl;
+
+    // print data
+    std::vector<std::string> test_names;
+    for (const auto& chart : charts) {
+        if (chart.memory) {
+            print_memory_test_data(out, test_names, chart.name, chart.axis, chart.metric, chart.data);
+        } else {
+            print_test_data(out, test_names, chart.name, chart.axis, chart.data);
+        }
+    }
+
+    out << "    }" << std::endl;
+    out << std::endl;
+    out << "    </script>" << std::endl;
+    out << "  </head>" << std::endl;
+    out << std::endl;
+    out << "  <body>" << std::endl;
+
+    // print divs for graphs
+    for (const auto& test_name : test_names) {
+        out << "<div id='div" << test_name << "'></div>" << std::endl;
+    }
+
+    out << "  </body>" << std::endl;
+    out << "</html>" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (!parse_options(argc, argv, options)) {
+        return EXIT_FAILURE;
+    }
+
+    Metadata meta = collect_metadata();
+    if (options.sweep == "cache") {
+        caches = read_caches(0);
+        if (caches.empty()) {
+            std::cerr << "cannot read cache sizes from /sys/devices/system/cpu/cpu0/cache" << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::string str;
+        for (const auto& cache : caches) {
+            str += (str.empty() ? "L" : ", L") + std::to_string(cache.level) + " " + format_bytes(cache.size);
+        }
+        meta["caches"] = str;
+        std::cout << "cache sweep over " << str << std::endl;
+    }
+    for (const auto& path : options.traces) {
+        traces.emplace_back();
+        if (!traces.back().open(path)) {
+            return EXIT_FAILURE;
+        }
+    }
+    for (const auto& str : options.workloads) {
+        WorkloadSpec spec;
+        std::string error;
+        if (!parse_workload(str, spec, error)) {
+            std::cerr << "invalid workload '" << str << "': " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        workloads.push_back(spec);
+    }
+    if (options.input.empty()) {
+        plan_tests();
+        if (!run_cells()) {
+            return EXIT_FAILURE;
+        }
+        for (const auto& cell : cells) {
+            results.push_back(cell.r);
+        }
+
+        std::ofstream html_file(options.output);
+        print_html(html_file);
+        html_file.close();
+        if (unstable_count > 0) {
+            std::cout << unstable_count << " measurements did not reach the "
+                      << options.runner.target_ci * 100 << "% confidence target (marked '!')"
+                      << std::endl;
+        }
+    } else if (!read_results_json(options.input, meta, results)) {
+        return EXIT_FAILURE;
+    }
+
+    if (!options.json.empty()) {
+        std::ofstream json_file(options.json);
+        write_results_json(json_file, meta, results);
+    }
+    if (!options.csv.empty()) {
+        std::ofstream csv_file(options.csv);
+        write_results_csv(csv_file, meta, results);
+    }
+
+    Metadata base_meta;
+    std::vector<Result> baseline;
+    if (!options.compare.empty() && !read_results_json(options.compare, base_meta, baseline)) {
+        return EXIT_FAILURE;
+    }
+
+    if (std::any_of(results.begin(), results.end(), [](const Result& r) { return r.counted; })) {
+        std::cout << "element counts:" << std::endl;
+        report_counts(results);
+    }
+
+    if (std::any_of(results.begin(), results.end(), [](const Result& r) { return r.threads > 1; })) {
+        std::cout << "thread scaling:" << std::endl;
+        report_scaling(results);
+    }
+
+    size_t changes;
+    std::cout << "complexity fits:" << std::endl;
+    size_t violations = report_complexity(results, baseline, options.fit_tolerance, changes);
+    if (violations > 0) {
+        std::cout << violations << " series grow faster than expected" << std::endl;
+    }
+
+    size_t regressions = 0;
+    if (!options.compare.empty()) {
+        regressions = compare_results(base_meta, baseline, results, options.threshold);
+        std::cout << changes << " series changed complexity" << std::endl;
+    }
+
+    if (regressions > 0 || changes > 0 || (options.assert_complexity && violations > 0)) {
+        return 2;
+    }
     return EXIT_SUCCESS;
 }
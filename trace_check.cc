@@ -0,0 +1,80 @@
+//
+// trace_check.cc
+//
+// Records operations with TraceRecorder and checks that TraceFile reads them
+// back unchanged
+//
+// Authors : Gokcehan Kara <gokcehankara@gmail.com>
+// License : This file is placed in the public domain.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Trace.h"
+#include "TraceRecorder.h"
+
+int main()
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr ? dir : "/tmp") + "/trace-check-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        std::cerr << "cannot create a temporary trace file" << std::endl;
+        return EXIT_FAILURE;
+    }
+    close(fd);
+
+    // more records than the writer buffers, so that several blocks are flushed
+    std::vector<uint32_t> expected;
+    {
+        TraceRecorder<std::deque<int>> recorder(path);
+        if (!recorder.is_recording()) {
+            std::cerr << "cannot record to '" << path << "'" << std::endl;
+            unlink(path.c_str());
+            return EXIT_FAILURE;
+        }
+        for (int i = 0; i < 10000; ++i) {
+            recorder.push_back(i);
+            expected.push_back(trace_record(TRACE_PUSH_BACK, 0));
+            if (i % 3 == 0) {
+                recorder.push_front(i);
+                expected.push_back(trace_record(TRACE_PUSH_FRONT, 0));
+            }
+            recorder[i / 2];
+            expected.push_back(trace_record(TRACE_INDEX, i / 2));
+            if (i % 5 == 0) {
+                recorder.pop_front();
+                expected.push_back(trace_record(TRACE_POP_FRONT, 0));
+                recorder.pop_back();
+                expected.push_back(trace_record(TRACE_POP_BACK, 0));
+            }
+        }
+    }
+
+    TraceFile trace;
+    bool ok = trace.open(path);
+    unlink(path.c_str());
+    if (!ok) {
+        return EXIT_FAILURE;
+    }
+    if (trace.size() != expected.size() ||
+        !std::equal(expected.begin(), expected.end(), trace.begin())) {
+        std::cerr << "trace read back differs from the recorded operations" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const unsigned ops = OP_PUSH_BACK | OP_POP_BACK | OP_PUSH_FRONT | OP_POP_FRONT | OP_RANDOM_ACCESS;
+    if (trace.operations() != ops) {
+        std::cerr << "trace operations differ from the recorded ones" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "trace check passed (" << trace.size() << " records)" << std::endl;
+    return EXIT_SUCCESS;
+}